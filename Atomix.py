@@ -56,6 +56,11 @@ defineConvert = {
 	'layer': 'AlgLayeredAStar',
 	'layered': 'AlgLayeredAStar',
 	'layeredastar': 'AlgLayeredAStar',
+	'ext': 'AlgExternalAStar',
+	'external': 'AlgExternalAStar',
+	'bfhs': 'AlgBFHS',
+	'mm': 'AlgMM',
+	'bidirectional': 'AlgMM',
 	'afs': 'HeuAllFinalStates', 
 	'allfinalstates': 'HeuAllFinalStates',
 	'ofs': 'HeuOneFinalState',
@@ -77,7 +82,10 @@ defineConvert = {
 	'dynamic': 'PDBDynamic',
 	'multigoal': 'PDBMultiGoal',
 	'random': 'RandomStaticPDBRandom',
-	'greedy': 'RandomStaticPDBGreedy'
+	'greedy': 'RandomStaticPDBGreedy',
+	'byte': 'PDBStorageByte',
+	'nibble': 'PDBStorageNibble',
+	'min': 'PDBStorageMin'
 	}
 
 
@@ -85,79 +93,64 @@ defineConvert = {
 # Write parameters 
 # =============================================================================
 
-def writeParameters(inputPath, outputPath):
+def readNumAtoms(inputPath):
 	with open(inputPath, 'r') as fin:
-		lines = fin.readlines()
-		lines = [x[:-1] for x in lines] # remove \n		
-		instanceName = lines[0]
-		numAtoms = lines[1]
-
-		x = lines[2].split(' ')
-		boardWidth, boardHeight = x[0], x[1]
-		boardSize = str(int(boardWidth) * int(boardHeight))
-		board = ''
-		for i in xrange(int(boardHeight)):
-			board += lines[3 + i]
-		board = board.replace('\r', '')
-
-		x = lines[3 + int(boardHeight)]
-		moleWidth, moleHeight = x.split(' ')[0], x.split(' ')[1]
-		mole = ''
-		for i in xrange(int(moleHeight)):
-			mole += lines[4 + int(boardHeight) + i]
-		mole = mole.replace('\r', '')
-		
-		numFinalStates = lines[4 + int(boardHeight) + int(moleHeight)]
-		numFreePositions = lines[5 + int(boardHeight) + int(moleHeight)]
-			
-		with open('src/Parameters.h', 'w') as fout:
-			fout.write('#pragma once\n#include \"Definitions.h\"\n')
-			fout.write('#define InstanceName \"' + 
-			  inputPath.replace('Levels/', '') + '\"\n')
-			fout.write('#define NumAtoms ' + numAtoms + '\n')
-			fout.write('#define NumFinalStates ' + numFinalStates + '\n')
-			fout.write('#define BoardWidth ' + boardWidth + '\n')
-			fout.write('#define BoardHeight ' + boardHeight + '\n')
-			fout.write('#define BoardSize ' + boardSize + '\n')
-			fout.write('#define MoleWidth ' + moleWidth + '\n')
-			fout.write('#define MoleHeight ' + moleHeight + '\n')
-			fout.write('#define MoleSize ' + 
-				str(int(moleWidth) * int(moleHeight)) + '\n')
-			fout.write('#define NumFreePositions ' + numFreePositions)
-			fout.write('\n')
-			fout.write('const char ParamBoard[] = \"' + board + '\";\n')
-			fout.write('const char ParamMole[] = \"' + mole + '\";\n')
-			fout.write('\n// Runtime parameters \n\n')
-			fout.write('#define ParamInputFile \"' + 
-			  inputPath.replace('Levels/', '') + '\"\n')
-			fout.write('#define ParamOutputFile \"' + outputPath +'\"\n')
-			fout.write('#define ParamTimeLimit ' + str(args['time']) + '\n')
-			fout.write('#define ParamMemoryLimit ' + str(args['memory']) + '\n')
-			fout.write('#define ParamAlgorithm ' + defineConvert[args['alg']] 
-				+ '\n')
-			fout.write('#define ParamHeuristic ' + defineConvert[args['heu']]
-				+ '\n')
-			fout.write('#define ParamTieBreaking ' + defineConvert[args['tb']] 
-				+ '\n')
-			fout.write('#define ParamPDB ' + defineConvert[args['pdb']] + '\n')
-			fout.write('#define ParamSilent ' 
-				+ str(args['silent']).lower() + '\n')
-			fout.write('#define ParamPrintOutputPath ' 
-				+ str(args['path']).lower() + '\n')
-			fout.write('#define ParamPrintInitialHeuristic ' 
-				+ str(args['initial']).lower() + '\n')
-			fout.write('#define ParamNumRandomStaticPDBs '
-				+ str(args['numstatic']) + '\n')
-			fout.write('#define ParamRandomSeed ' + str(args['seed']) + '\n')
-			fout.write('#define ParamRandomStaticPDB ' + 
-			  defineConvert[args['randomstatic']])
+		fin.readline() # instance name
+		return int(fin.readline())
+
+def writeParameters():
+	# only the parameters that select code are compiled in; the instance and 
+	# the other parameters are passed to the binary at runtime
+	p = '#pragma once\n#include \"Definitions.h\"\n'
+	p += '#include \"Instance.h\"\n#include \"Options.h\"\n'
+	p += '\n// Compile-time parameters; NumAtoms is given by the Makefile\n\n'
+	p += '#define ParamAlgorithm ' + defineConvert[args['alg']] + '\n'
+	p += '#define ParamHeuristic ' + defineConvert[args['heu']] + '\n'
+	p += '#define ParamTieBreaking ' + defineConvert[args['tb']] + '\n'
+	p += '#define ParamPDB ' + defineConvert[args['pdb']] + '\n'
+	p += '#define ParamNumThreads ' + str(args['threads']) + '\n'
+	p += '#define ParamPDBGroupSize ' + str(args['pdbgroupsize']) + '\n'
+	p += '#define ParamPDBStorage ' + defineConvert[args['pdbstorage']] + '\n'
+	p += '#define ParamCompactStates ' + \
+		('true' if args['compactstates'] else 'false') + '\n'
+	
+	# rewriting an unchanged file would make make rebuild everything
+	if os.path.isfile('src/Parameters.h'):
+		with open('src/Parameters.h', 'r') as fin:
+			if fin.read() == p:
+				return
+	with open('src/Parameters.h', 'w') as fout:
+		fout.write(p)
+
+def runCommand(inputPath, outputPath):
+	c = './atomix -i ' + os.path.abspath(inputPath)
+	if len(outputPath):
+		c += ' -o ' + outputPath
+	c += ' -t ' + str(args['time']) + ' -m ' + str(args['memory'])
+	c += ' --seed ' + str(args['seed'])
+	c += ' --numstatic ' + str(args['numstatic'])
+	c += ' --randomstatic ' + args['randomstatic']
+	if len(args['pdbcache']):
+		c += ' --pdbcache ' + os.path.abspath(args['pdbcache'])
+	if args['pdbthreads'] > 0:
+		c += ' --pdbthreads ' + str(args['pdbthreads'])
+	if len(args['extdir']):
+		c += ' --extdir ' + os.path.abspath(args['extdir'])
+	for o in ['checkpoint', 'resume']:
+		if len(args[o]):
+			c += ' --' + o + ' ' + os.path.abspath(args[o])
+	for o in ['silent', 'path', 'initial']:
+		if args[o]:
+			c += ' --' + o
+	return c
 
 # =============================================================================
 # Parameter options 
 # =============================================================================
 
 algorithmChoices = ['astar', 'idastar', 'layeredastar', 'peastar', 'pea', 
-					'layered', 'layer', 'a', 'ida']
+					'layered', 'layer', 'a', 'ida', 'external', 'ext', 'bfhs',
+					'mm', 'bidirectional']
 heuristicChoices = ['onefinalstate', 'ofs', 'allfinalstates', 'afs']
 tbChoices = ['fillorder', 'goalcount', 'numrealizablepaths', 'fo', 
 	'gc', 'nrp', 'h', 'gch', 'hgc', 'goalcounth', 'hgoalcount', 'none']
@@ -221,6 +214,29 @@ parser.add_argument('--pdb',
 	default = 'static',
 	help = 'which pattern database to use')
 
+parser.add_argument('--pdbgroupsize',
+	required = False,
+	type = int,
+	choices = [3, 4, 5],
+	default = 3,
+	help = 'number of atoms in the groups of static PDBs; groups of 4 or 5 ' +
+	'atoms give stronger heuristics, but need much more memory and time')
+
+parser.add_argument('--pdbstorage',
+	required = False,
+	type = str,
+	choices = ['byte', 'nibble', 'min'],
+	default = 'byte',
+	help = 'storage of PDB entries. \'nibble\': 4 bits per entry, saturated ' +
+	'at 15; \'min\': two adjacent entries share their minimum. both halve ' +
+	'the tables, and the memory saved goes to more static PDBs or states')
+
+parser.add_argument('--compactstates',
+	action = 'store_true',
+	help = 'store the states table without padding, and the atom positions ' +
+	'of each state as a rank; each state takes 12 to 20%% less memory, ' +
+	'but every lookup has to decode it')
+
 parser.add_argument('--seed', 
 	required = False,
 	type = int,
@@ -243,6 +259,47 @@ parser.add_argument('--randomstatic',
 	'random partitions that minimize inter-group distance; \'random\': one ' + 
 	'greedy partition, and the rest are fully random')
 
+parser.add_argument('--pdbcache',
+	required = False,
+	type = str,
+	default = '',
+	help = 'directory in which to store static PDBs; later runs on the same ' +
+	'board and goals load them instead of computing them')
+
+parser.add_argument('--pdbthreads',
+	required = False,
+	type = int,
+	default = 0,
+	help = 'number of threads that compute the static PDBs; 0 uses one ' +
+	'per hardware thread')
+
+parser.add_argument('--checkpoint',
+	required = False,
+	type = str,
+	default = '',
+	help = 'file to which an A* or PEA* search stopped by the time or ' +
+	'memory limit is written, so that it can be continued with --resume')
+
+parser.add_argument('--resume',
+	required = False,
+	type = str,
+	default = '',
+	help = 'file written by --checkpoint, from which to continue the search')
+
+parser.add_argument('--extdir',
+	required = False,
+	type = str,
+	default = '',
+	help = 'directory of the sorted run files of external A*, preferably ' +
+	'on a local SSD')
+
+parser.add_argument('--threads',
+	required = False,
+	type = int,
+	default = 1,
+	help = 'number of search threads; if larger than 1, A* and PEA* run as ' +
+	'hash-distributed A* (HDA*)')
+
 parser.add_argument('--silent',
 	help = 'silent option, program will not print to stdout',
 	action = 'store_true')
@@ -286,7 +343,10 @@ if len([i for i in inputInstances if not os.path.isfile(i)]):
 
 if (defineConvert[args['heu']] == 'HeuOneFinalState' and 
 		(defineConvert[args['alg']] == 'AlgAStar' or 
-		 defineConvert[args['alg']] == 'AlgPEAStar')):
+		 defineConvert[args['alg']] == 'AlgPEAStar' or
+		 defineConvert[args['alg']] == 'AlgExternalAStar' or
+		 defineConvert[args['alg']] == 'AlgBFHS' or
+		 defineConvert[args['alg']] == 'AlgMM')):
 	print ('Error: One Final State heuristic only admits IDA* or Layered A* as '
 		+ 'algorithm choices')
 	sys.exit()
@@ -295,6 +355,23 @@ if len(inputInstances) == 0:
 	print 'No input instances found.'
 	sys.exit()
 
+# build once, for the numbers of atoms of the input instances
+writeParameters()
+buckets = ' '.join(str(n) for n in sorted(set(readNumAtoms(i) 
+	for i in inputInstances)))
+nproc = (str(args['nproc']) if args['nproc'] > 0 
+	  else str(max(1, int(cmd('nproc')) / 2)))
+makeCommand = ('make -j ' + nproc + ' Buckets=\"' + buckets + '\"' + 
+	(' CFLAGS=-DNDEBUG' if args['ndebug'] else ''))
+print makeCommand
+res = cmd(makeCommand, cwd='src')
+if 'failed' in res.lower():
+	sys.exit()
+
+if args['build']:
+	print 'Successful build'
+	sys.exit()
+
 for i in inputInstances:
 	if os.path.isfile(args['out']):
 		outputInstance = str(args['out'])
@@ -313,19 +390,5 @@ for i in inputInstances:
 	else:
 		outputInstance = ''
 
-	writeParameters(i, outputInstance)
-	nproc = (str(args['nproc']) if args['nproc'] > 0 
-		  else str(int(cmd('nproc')) / 2))
-	makeCommand = 'make -j ' + nproc + (' CFLAGS=-DNDEBUG' 
-		if args['ndebug'] else '')
-	print makeCommand
-	res = cmd(makeCommand, cwd='src')
-	if 'failed' in res.lower() in res.lower():
-		sys.exit()
 	print ' '.join(sys.argv) + '\n'
-
-	if not args['build']:
-		sys.stdout.write(cmd('./atomix', cwd='src'))
-	else:
-		print 'Successful build'
-
+	sys.stdout.write(cmd(runCommand(i, outputInstance), cwd='src'))
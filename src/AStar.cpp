@@ -23,8 +23,12 @@
 * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #include "AStar.h"
+#include "AllFinalStates.h"
 #include "Atomix.h"
+#include "Checkpoint.h"
 #include "Definitions.h"
+#include "Exceptions.h"
+#include "Occupancy.h"
 #include "OneFinalState.h"
 #include "PDB.h"
 #include "Parameters.h"
@@ -39,23 +43,20 @@
 
 using namespace std;
 
-int atom_moved = -1;
+namespace AtomixNamespace {
+
+SearchThreadLocal int atom_moved = -1;
 int a_star_max_moves;
-State* cur_state = nullptr;
+SearchThreadLocal State* cur_state = nullptr;
 Index cur_state_index = -1;
 Index a_star_solution_index = -1;
 
-void heuristic_initial(State& s) {
+/* sets the standard heuristic of s, and its tie breaker */
+static void standard_heuristic_initial(State& s) {
 #if ParamHeuristic == HeuAllFinalStates
-  int best_f = 0;
-  s.std_h_value = numeric_limits<uchar>::max();
-  for (int f = 0; f < NumFinalStates; ++f) {
-    auto h = (uchar)final_states[f].standard_heuristic(s);
-    if (h < s.std_h_value) {
-      s.std_h_value = h;
-      best_f = f;
-    }
-  }
+  int h[MaxFinalStates];
+  int best_f = all_final_states_standard_heuristic(s, h);
+  s.std_h_value = h[best_f];
 #if ParamTieBreaking != None
   tie_breaking(s, best_f);
 #else
@@ -68,7 +69,10 @@ void heuristic_initial(State& s) {
   tie_breaking(s);
 #endif
 #endif
+}
 
+void heuristic_initial(State& s) {
+  standard_heuristic_initial(s);
 #if ParamPDB != None
   heuristic_pdb(s);
 #endif
@@ -76,11 +80,12 @@ void heuristic_initial(State& s) {
 
 void heuristic_delta(State& s) {
   ++stat_calls_to_heuristic;
-#if ParamHeuristic == HeuAllFinalStates && NumFinalStates > 1
-  heuristic_initial(s);
-#else
 #if ParamHeuristic == HeuAllFinalStates
-  static_assert(NumFinalStates == 1, "");
+  if (NumFinalStates > 1) {
+    standard_heuristic_initial(s);
+    heuristic_pdb_delta(s);
+    return;
+  }
   auto& F = final_states[0];
 #elif ParamHeuristic == HeuOneFinalState
   auto& F = single_final_state;
@@ -93,48 +98,58 @@ void heuristic_delta(State& s) {
 #if ParamTieBreaking != None
   tie_breaking_delta(s, *cur_state, atom_moved);
 #endif
-#endif
-  heuristic_pdb(s);
+  heuristic_pdb_delta(s);
 }
 
 std::vector<State> get_solution_path(Index s) {
   std::vector<State> v;
 #if SaveSolutionPath
   while (s != -1) {
-    v.push_back(states_table(s));
-    s = states_table(s).parent;
+    v.push_back(states_table.get_state(s));
+    s = states_table.info(s).parent;
   }
 #else
-  v.push_back(states_table(s));
+  v.push_back(states_table.get_state(s));
 #endif
   return v;
 }
 
 vector<State> a_star(int max_moves) {
   auto& tb = states_table;
+  static State cur;
   a_star_max_moves = max_moves;
   a_star_solution_index = -1;
   tb.reset();
 
-  // insert initial state
-  heuristic_initial(initial_state);
-  initial_state.g_value = 0;
-  auto initial = tb.insert(initial_state);
+  if (not checkpoint_resume(max_moves)) {
+    // insert initial state
+    heuristic_initial(initial_state);
+    initial_state.g_value = 0;
+    auto initial = tb.insert(initial_state);
 
-  tb.pq_push(initial);
+    tb.pq_push(initial);
 
 #if ParamAlgorithm == AlgPEAStar
-  tb(initial).pea_F = 0;
+    tb.info(initial).pea_F = 0;
 #endif
+  }
 
   // main loop
   while (true) {
     cur_state_index = tb.pq_pop();
     if (cur_state_index == -1) break;
 
-    cur_state = &tb(cur_state_index);
+    /* expand a copy, since with CompactStates the table holds no State */
+    cur = tb.get_state(cur_state_index);
+    cur_state = &cur;
 
-    if (termination_requested) return {};
+    if (termination_requested) {
+      /* the state goes back to the queue, so that a resumed search expands
+       * it first */
+      tb.pq_push(cur_state_index);
+      checkpoint_save(max_moves);
+      return {};
+    }
 
     stat_lower_bound = max(stat_lower_bound, (int)cur_state->f_value());
 
@@ -147,7 +162,15 @@ vector<State> a_star(int max_moves) {
     ++stat_nodes_expanded_with_g_value[cur_state->g_value];
     ++stat_nodes_expanded_with_h_value[cur_state->h_value];
 #endif
-    expand_node();
+    try {
+      expand_node();
+    } catch (TerminationException&) {
+      /* the states table is full. the children inserted so far stay in it,
+       * and a resumed search expands the state again */
+      tb.pq_push(cur_state_index);
+      checkpoint_save(max_moves);
+      throw;
+    }
 
     if (a_star_solution_index != -1) {
       println("Ending because final solution has been generated.");
@@ -161,24 +184,20 @@ vector<State> a_star(int max_moves) {
 void expand_node() {
   auto& tb = states_table;
   // visit all neighbours
+  const Occupancy occ = occupancy(*cur_state);
+  const size_t cur_hash = cur_state->get_hash();
   for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
     auto atom_pos = cur_state->v[atom_moved];
-    for (auto d : PosDirections) {
-      auto atom_pos_moved = atom_pos;
-
-      // atom walks
-      // TODO pos_valid function doesn't need to be called here.
-      while (pos_valid(atom_pos_moved + d) and
-             not cur_state->is_obstacle(atom_pos_moved + d))
-        atom_pos_moved += d;
+    for (int d = 0; d < 4; ++d) {
+      // atom slides
+      auto atom_pos_moved = slide(occ, atom_pos, d);
 
       if (atom_pos == atom_pos_moved) {
         continue;
       }
 
       // apply move
-      State& tmp = tb(0);
-      tmp = *cur_state;
+      State tmp = *cur_state;
       tmp.v[atom_moved] = atom_pos_moved;
       tmp.g_value = cur_state->g_value + 1;
 
@@ -190,8 +209,10 @@ void expand_node() {
         int gb = group_begin[atom_moved];
         sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
       }
+      size_t hash = hash_move(cur_hash, atom_moved, atom_pos, atom_pos_moved);
+      assert(hash == tmp.get_hash());
 
-      Index i = tb.hash_find(0);
+      Index i = tb.hash_find(tmp, hash);
       if (i == -1) {
         heuristic_delta(tmp);
         if (tmp.h_value == 0) {
@@ -199,27 +220,55 @@ void expand_node() {
           if (tmp.g_value > a_star_max_moves) continue;
 #if ParamAlgorithm == AlgLayeredAStar
           // in layered A*, we can end when generating a solution node
-          a_star_solution_index = 0;
+          a_star_solution_index = tb.insert(tmp, hash);
           return;
 #endif
         }
         if (tmp.f_value() > a_star_max_moves) continue;
-        tb.pq_push(tb.insert(tmp));
-      } else if (tmp.g_value < tb(i).g_value) {
-        if (tmp.g_value + tb(i).h_value > a_star_max_moves) continue;
+        tb.pq_push(tb.insert(tmp, hash));
+      } else if (tmp.g_value < tb.info(i).g_value) {
+        if (tmp.g_value + tb.info(i).h_value > a_star_max_moves) continue;
         tb.pq_update(i, tmp.g_value);
 
 #if SaveSolutionPath
-        tb(i).parent = tmp.parent;
+        tb.info(i).parent = tmp.parent;
 #endif
       }
     }
   }
 }
 #else
+#if PEAOperatorSelection
+static signed char pea_std_delta[NumAtoms][MaxBoardSize][4];
+#endif
+
+void pea_init_operator_selection() {
+#if PEAOperatorSelection
+  auto& dist = relaxed_distances;
+  for (int a = 0; a < NumAtoms; ++a) {
+    vector<Pos> goals;
+    for (int f = 0; f < NumFinalStates; ++f)
+      for (int x = group_begin[a]; x < group_begin[a] + group_size[a]; ++x)
+        goals.push_back(final_states[f].v[x]);
+    for (int i = 0; i < NumFreePositions; ++i) {
+      Pos p = board_free_cell[i];
+      for (int d = 0; d < 4; ++d) {
+        int delta = 1;
+        for (const int* x = &board_ray[board_ray_begin[i][d]]; *x != -1; ++x)
+          for (Pos g : goals)
+            delta = min(delta, dist[board_free_cell[*x]][g] - dist[p][g]);
+        pea_std_delta[a][p][d] = delta;
+      }
+    }
+  }
+#endif
+}
+
 void expand_node() {
+  static State neighbours[MaxNeighbours];
   static int min_neighbours[MaxNeighbours]; /* neighbours with min f */
   static int min_neighbours_hash_indexes[MaxNeighbours];
+  static size_t neighbours_hashes[MaxNeighbours];
   int neighbour_index = -1;
   int neighbours_count = 0;
   int num_min_neighbours = 0;
@@ -227,21 +276,45 @@ void expand_node() {
   int next_pea_F = numeric_limits<int>::max();
   auto& tb = states_table;
 
+  const Occupancy occ = occupancy(*cur_state);
+  const size_t cur_hash = cur_state->get_hash();
+#if PEAOperatorSelection
+  /* the children are only inserted now if their f is at most the current f
+   * of the parent. without PDBs, std_h_value shares storage with h_value, 
+   * which is raised when the parent is reinserted, so the standard heuristic
+   * of the parent is only known in its first expansion */
+#if ParamPDB != None
+  const bool select_operators = true;
+#else
+  const bool select_operators = cur_state->pea_F == 0;
+#endif
+  const int min_child_f = cur_state->g_value + 1 + cur_state->std_h_value;
+#endif
   for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
     auto atom_pos = cur_state->v[atom_moved];
-    for (auto d : PosDirections) {
+    for (int d = 0; d < 4; ++d) {
       ++neighbour_index;
-      auto atom_pos_moved = atom_pos;
-      // TODO pos_valid function doesn't need to be called here.
-      while (pos_valid(atom_pos_moved + d) and
-             not cur_state->is_obstacle(atom_pos_moved + d))
-        atom_pos_moved += d;
+      auto atom_pos_moved = slide(occ, atom_pos, d);
 
       if (atom_pos == atom_pos_moved) {
         continue;
       }
 
-      State& tmp = tb(neighbour_index);
+#if PEAOperatorSelection
+      if (select_operators) {
+        int child_f = min_child_f + pea_std_delta[atom_moved][atom_pos][d];
+        if (child_f > cur_state->f_value()) {
+          /* not generated, but it is still a child left for a later 
+           * expansion, whose f is at least child_f */
+          if (child_f > a_star_max_moves) continue;
+          ++neighbours_count;
+          next_pea_F = min(next_pea_F, child_f);
+          continue;
+        }
+      }
+#endif
+
+      State& tmp = neighbours[neighbour_index];
       tmp = *cur_state;
       tmp.v[atom_moved] = atom_pos_moved;
       tmp.pea_F = 0;
@@ -250,17 +323,20 @@ void expand_node() {
         int gb = group_begin[atom_moved];
         sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
       }
+      size_t& hash = neighbours_hashes[neighbour_index];
+      hash = hash_move(cur_hash, atom_moved, atom_pos, atom_pos_moved);
+      assert(hash == tmp.get_hash());
 
-      Index i = tb.hash_find(neighbour_index);
+      Index i = tb.hash_find(tmp, hash);
       if (i != -1) {
-        if (cur_state->g_value + 1 >= tb(i).g_value) {
+        if (cur_state->g_value + 1 >= tb.info(i).g_value) {
           // re-generating already generated state. proceed only
           // if it improves
           continue;
         }
-        tmp.h_value = tb(i).h_value;
-        tmp.std_h_value = tb(i).std_h_value;
-        tmp.tie_breaker = tb(i).tie_breaker;
+        tmp.h_value = tb.info(i).h_value;
+        tmp.std_h_value = tb.info(i).std_h_value;
+        tmp.tie_breaker = tb.info(i).tie_breaker;
       } else {
         heuristic_delta(tmp);
       }
@@ -303,44 +379,47 @@ void expand_node() {
   assert(neighbour_index == MaxNeighbours - 1);
   assert(neighbours_count >= num_min_neighbours);
 
-  cur_state->pea_F = next_pea_F;
-
-  if (neighbours_count > num_min_neighbours) {
-    // still neighbours left, reinsert current state
-    assert(next_pea_F != numeric_limits<int>::max());
-
-    // update cur state f value
-    cur_state->h_value = next_pea_F - cur_state->g_value;
-    tb.pq_push(cur_state_index);
-    ++stat_num_reopened_states;
-  } else {
-    assert(next_pea_F == numeric_limits<int>::max());
-  }
-
+  /* the children are inserted before the current state is updated and 
+   * reinserted, so that if the states table fills up, the state is as it 
+   * was popped, and a_star can queue it again to be expanded in full */
   for (int j = 0; j < num_min_neighbours; ++j) {
     // insert all neighbours with f = fmin
     int h = min_neighbours[j];
-    State& tmp = tb(h);
+    State& tmp = neighbours[h];
 
     if (tmp.h_value == 0) {
-      a_star_solution_index = h;
+      a_star_solution_index = tb.insert(tmp, neighbours_hashes[h]);
       return;
     }
 
     Index i = min_neighbours_hash_indexes[j];
     if (i == -1) {
-      tb.pq_push(tb.insert(tmp));
-    } else { // if (tmp.g_value < tb(i).g_value) {
-      assert(tmp.g_value < tb(i).g_value);
+      tb.pq_push(tb.insert(tmp, neighbours_hashes[h]));
+    } else { // if (tmp.g_value < tb.info(i).g_value) {
+      assert(tmp.g_value < tb.info(i).g_value);
       tb.pq_update(i, tmp.g_value);
-      tb(i).pea_F = 0;
+      tb.info(i).pea_F = 0;
 
 #if SaveSolutionPath
-      tb(i).parent = tmp.parent;
+      tb.info(i).parent = tmp.parent;
       assert(tmp.parent == cur_state_index);
 #endif
     }
   }
+
+  tb.info(cur_state_index).pea_F = next_pea_F;
+
+  if (neighbours_count > num_min_neighbours) {
+    // still neighbours left, reinsert current state
+    assert(next_pea_F != numeric_limits<int>::max());
+
+    // update cur state f value
+    tb.info(cur_state_index).h_value = next_pea_F - cur_state->g_value;
+    tb.pq_push(cur_state_index);
+    ++stat_num_reopened_states;
+  } else {
+    assert(next_pea_F == numeric_limits<int>::max());
+  }
 }
 #endif //  ParamAlgorithm != AlgPEAStar
 
@@ -356,7 +435,7 @@ vector<vector<State>> backward_bfs(State& input_state, int num_paths,
     while (true) {
       int cur_state_index = tb.pq_pop();
       if (cur_state_index == -1) break;
-      auto& cur = tb(cur_state_index);
+      auto cur = tb.get_state(cur_state_index);
       if (cur.g_value > depth) {
         depth = cur.g_value;
         print("depth: ", depth, "\n");
@@ -364,30 +443,24 @@ vector<vector<State>> backward_bfs(State& input_state, int num_paths,
       if (cur.g_value == max_moves) continue;
       if (termination_requested) break;
 
+      const Occupancy occ = occupancy(cur);
       for (int atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
         auto atom_pos = cur.v[atom_moved];
-        for (auto d : PosDirections) {
-          assert(int(atom_pos - d) >= 0 && int(atom_pos - d) < 256);
-          int atom_pos_moved = atom_pos;
-          if (cur.is_obstacle(atom_pos_moved - d)) { // can have "impulse"
-            while (not cur.is_obstacle(atom_pos_moved + d)) {
-              assert(int(atom_pos + d) >= 0 && int(atom_pos + d) < 256);
-              atom_pos_moved += d;
-              State& tmp = tb(0);
-              tmp = cur;
-              tmp.v[atom_moved] = atom_pos_moved;
-              tmp.g_value = cur.g_value + 1;
+        for (int d = 0; d < 4; ++d) {
+          reverse_slides(occ, atom_pos, d, [&](Pos atom_pos_moved) {
+            State tmp = cur;
+            tmp.v[atom_moved] = atom_pos_moved;
+            tmp.g_value = cur.g_value + 1;
 #if SaveSolutionPath
-              tmp.parent = cur_state_index;
+            tmp.parent = cur_state_index;
 #endif
-              if (atom_moved >= multi_start_index) {
-                int gb = group_begin[atom_moved];
-                sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
-              }
-              Index i = tb.hash_find(0);
-              if (i == -1) tb.pq_push(tb.insert(tmp));
+            if (atom_moved >= multi_start_index) {
+              int gb = group_begin[atom_moved];
+              sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
             }
-          }
+            Index i = tb.hash_find(tmp);
+            if (i == -1) tb.pq_push(tb.insert(tmp));
+          });
         }
       }
     }
@@ -398,8 +471,8 @@ vector<vector<State>> backward_bfs(State& input_state, int num_paths,
   for (int p = 0; p < num_paths; ++p) {
     int st = random_number<int>(0, tb.states_top - 1);
     while (st != -1) {
-      sol[p].push_back(tb(st));
-      st = tb(st).parent;
+      sol[p].push_back(tb.get_state(st));
+      st = tb.info(st).parent;
     }
   }
 
@@ -412,3 +485,5 @@ vector<vector<State>> backward_bfs(State& input_state, int num_paths,
         "\n");
   return sol;
 }
+
+} // namespace AtomixNamespace
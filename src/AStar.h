@@ -29,6 +29,13 @@
 #include <set>
 #include <vector>
 
+namespace AtomixNamespace {
+
+/* the state being expanded and the atom that was moved to generate the state
+ * passed to heuristic_delta */
+extern SearchThreadLocal State* cur_state;
+extern SearchThreadLocal int atom_moved;
+
 void heuristic_initial(State& s);
 
 void heuristic_delta(State& s);
@@ -39,5 +46,18 @@ std::vector<State> a_star(int max_moves = std::numeric_limits<int>::max());
 
 void expand_node();
 
+/* with PEA*, the children of a state that can't have the f-value needed in an
+ * expansion are skipped before they are generated (enhanced partial 
+ * expansion, Felner et al., 2012), using a table of lower bounds on the 
+ * change in the standard heuristic of each move. a slide changes the relaxed
+ * distance of the atom to a goal cell by at most one, so the bound of atom a
+ * from cell p in direction d is the smallest change over the cells where the
+ * slide can stop, and the goal cells of a in all final states */
+#define PEAOperatorSelection true
+
+void pea_init_operator_selection();
+
 std::vector<std::vector<State>> backward_bfs(State& input_state, int num_paths,
                                              int max_moves);
+
+} // namespace AtomixNamespace
@@ -26,13 +26,41 @@
 #include "OneFinalState.h"
 #include "Atomix.h"
 #include "AStar.h"
+#include "BFHS.h"
+#include "Bidirectional.h"
+#include "ExternalAStar.h"
+#include "HDAStar.h"
 #include "Print.h"
 #include "Statistics.h"
+#include "Board.h"
 #include <ciso646>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+/* functions marked SimdClones are compiled for AVX2 and for the baseline 
+ * instruction set, and the version that the CPU supports is chosen when the
+ * program is loaded */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SimdClones __attribute__((target_clones("avx2", "default")))
+#else 
+#define SimdClones
+#endif
+
+namespace AtomixNamespace {
 
 std::vector<State> all_final_states() {
 #if ParamAlgorithm == AlgLayeredAStar
 	return all_final_states_layered();
+#elif ParamAlgorithm == AlgExternalAStar
+	return external_a_star();
+#elif ParamAlgorithm == AlgBFHS
+	return bfhs();
+#elif ParamAlgorithm == AlgMM
+	return bidirectional_search();
+#elif ParamNumThreads > 1
+	return hda_star();
 #else 
 	return a_star();
 #endif 
@@ -52,3 +80,81 @@ std::vector<State> all_final_states_layered() {
 	return{};
 }
 
+/* the standard heuristic against all final states is evaluated for all of 
+ * them at once: goal_dist holds, for atom i and free cell c, the relaxed 
+ * distances of c to the goal of atom i in every final state, one per lane.
+ * the lanes are padded to a multiple of 16, which fills AVX2 registers */
+#define NumLanes ((NumFinalStates + 15) / 16 * 16)
+#define GoalDist(i, p) (&goal_dist[((i) * NumFreePositions + \
+	board_free_index[p]) * NumLanes])
+
+static std::vector<uint16_t> goal_dist;
+
+void init_all_final_states_heuristic() {
+	goal_dist.assign((size_t)NumAtoms * NumFreePositions * NumLanes, 0);
+	for (int i = 0; i < NumAtoms; ++i)
+		for (int c = 0; c < NumFreePositions; ++c)
+			for (int f = 0; f < NumFinalStates; ++f)
+				GoalDist(i, board_free_cell[c])[f] = std::min(255, 
+					relaxed_distances[final_states[f].v[i]][board_free_cell[c]]);
+}
+
+/* adds, in every lane, the distances of the single atoms, and the best 
+ * matchings of the identical-atom groups of up to 3 atoms */
+SimdClones
+static void add_standard_heuristic_lanes(const State& s, uint16_t* h) {
+	const int n = NumLanes;
+	for (int a = 0; a < multi_start_index; ++a) {
+		auto d = GoalDist(a, s.v[a]);
+		for (int f = 0; f < n; ++f) h[f] += d[f];
+	}
+	/* the atoms from multi_start_index on are matched by identical-atom 
+	 * group, and a group there may also have a single atom */
+	for (int a = multi_start_index; a < NumAtoms; a += group_size[a]) {
+		if (group_size[a] == 1) {
+			auto d = GoalDist(a, s.v[a]);
+			for (int f = 0; f < n; ++f) h[f] += d[f];
+		} else if (group_size[a] == 2) {
+			/* dij is the distance of atom a + j to the goal of atom a + i */
+			auto d00 = GoalDist(a, s.v[a]), d01 = GoalDist(a, s.v[a + 1]),
+				d10 = GoalDist(a + 1, s.v[a]), d11 = GoalDist(a + 1, s.v[a + 1]);
+			for (int f = 0; f < n; ++f)
+				h[f] += std::min<uint16_t>(d00[f] + d11[f], d10[f] + d01[f]);
+		} else if (group_size[a] == 3) {
+			const uint16_t* d[3][3];
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+					d[i][j] = GoalDist(a + i, s.v[a + j]);
+			for (int f = 0; f < n; ++f) {
+				uint16_t i1 = d[0][0][f] + d[1][1][f] + d[2][2][f],
+					i2 = d[0][0][f] + d[1][2][f] + d[2][1][f],
+					i3 = d[0][1][f] + d[1][0][f] + d[2][2][f],
+					i4 = d[0][1][f] + d[1][2][f] + d[2][0][f],
+					i5 = d[0][2][f] + d[1][0][f] + d[2][1][f],
+					i6 = d[0][2][f] + d[1][1][f] + d[2][0][f];
+				h[f] += std::min(std::min(i1, i2), 
+					std::min(std::min(i3, i4), std::min(i5, i6)));
+			}
+		}
+	}
+}
+
+int all_final_states_standard_heuristic(const State& s, int* h) {
+	alignas(32) uint16_t lanes[MaxFinalStates];
+	std::fill(lanes, lanes + NumLanes, 0);
+	add_standard_heuristic_lanes(s, lanes);
+
+	int best_f = 0;
+	for (int f = 0; f < NumFinalStates; ++f) {
+		h[f] = lanes[f];
+		/* larger groups are matched one final state at a time */
+		for (int a = multi_start_index; a < NumAtoms; a += group_size[a])
+			if (group_size[a] > 3)
+				h[f] += final_states[f].multi_atom_matching(s, a);
+		assert(h[f] == final_states[f].standard_heuristic(s));
+		if ((uchar)h[f] < (uchar)h[best_f]) best_f = f;
+	}
+	return best_f;
+}
+
+} // namespace AtomixNamespace
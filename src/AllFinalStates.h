@@ -26,6 +26,18 @@
 #include <vector>
 #include "State.h"
 
+namespace AtomixNamespace {
+
 std::vector<State> all_final_states();
 
-std::vector<State> all_final_states_layered();
\ No newline at end of file
+std::vector<State> all_final_states_layered();
+
+/* builds the tables of all_final_states_standard_heuristic. called after the
+ * final states and relaxed distances are known */
+void init_all_final_states_heuristic();
+
+/* sets h[f] to final_states[f].standard_heuristic(s) for every final state 
+ * f, and returns the first f with the smallest h[f], as uchar */
+int all_final_states_standard_heuristic(const State& s, int* h);
+
+} // namespace AtomixNamespace
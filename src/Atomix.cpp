@@ -29,8 +29,11 @@
 #include "TieBreaking.h"
 #include "StatesTable.h"
 #include "DynamicPDB.h"
+#include "AllFinalStates.h"
+#include "AStar.h"
 #include "StaticPDB.h"
 #include "Statistics.h"
+#include "CompactState.h"
 #include <cctype>
 #include <cstring>
 #include <cassert>
@@ -41,6 +44,8 @@
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 bool termination_requested = false;
 size_t current_memory = 0;
 
@@ -51,11 +56,12 @@ char index_to_label[256];
 int label_to_index[256];
 
 State initial_state;
-State final_states[NumFinalStates];
+State final_states[MaxFinalStates];
 
-int relaxed_distances[BoardSize][BoardSize];
+int relaxed_distances[MaxBoardSize][MaxBoardSize];
 
 void preprocess() {
+	pos_init();
 	memcpy(board, ParamBoard, BoardSize * sizeof(char));
 
 	pair<unsigned char, vector<Pos>> atom_positions[256];
@@ -113,11 +119,22 @@ void preprocess() {
 	num_atom_types = 0;
 	for (int i = 0; i < NumAtoms; i += group_size[i])
 		++num_atom_types;
+	zobrist_init();
 
 	board_remove_atoms();
 	board_flood();
 	find_final_states();
 	compute_relaxed_distances();
+#if ParamHeuristic == HeuAllFinalStates
+	init_all_final_states_heuristic();
+#endif
+#if ParamAlgorithm == AlgPEAStar
+	pea_init_operator_selection();
+#endif
+
+#if CompactStates
+	compact_state_init();
+#endif 
 
 #if ParamTieBreaking == TBFillOrder or ParamTieBreaking == TBFillOrderReverse
 	compute_fill_order_ranks();
@@ -185,7 +202,7 @@ void find_final_states() {
 
 	if (final_state_index != NumFinalStates) {
 		println("Final States found by C++: ", final_state_index);
-		println("Final States found by python: ", NumFinalStates);
+		println("Final States given by the input file: ", NumFinalStates);
 
 		exit(-1);
 	}
@@ -194,8 +211,10 @@ void find_final_states() {
 	/* sort the atoms with duplicates by the lexicographical order of their
 	* positions */
 	for (int i = multi_start_index; i < NumAtoms; i += group_size[i]) {
-		for (auto& s : final_states)
+		for (int f = 0; f < NumFinalStates; ++f) {
+			auto& s = final_states[f];
 			sort(begin(s.v) + i, begin(s.v) + i + group_size[i]);
+		}
 	}
 }
 
@@ -222,3 +241,5 @@ void compute_relaxed_distances() {
 		}
 	}
 }
+
+} // namespace AtomixNamespace
@@ -26,6 +26,8 @@
 #include "Pos.h"
 #include "State.h"
 
+namespace AtomixNamespace {
+
 void preprocess();
 
 void find_final_states();
@@ -42,6 +44,8 @@ extern char index_to_label[256];
 extern int label_to_index[256];
 
 extern State initial_state;
-extern State final_states[NumFinalStates];
+extern State final_states[MaxFinalStates];
+
+extern int relaxed_distances[MaxBoardSize][MaxBoardSize];
 
-extern int relaxed_distances[BoardSize][BoardSize];
\ No newline at end of file
+} // namespace AtomixNamespace
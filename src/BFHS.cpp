@@ -0,0 +1,202 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "BFHS.h"
+#include "AStar.h"
+#include "Atomix.h"
+#include "Exceptions.h"
+#include "Occupancy.h"
+#include "Parameters.h"
+#include "Print.h"
+#include "StateSet.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ciso646>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#if ParamAlgorithm == AlgBFHS
+
+static_assert(ParamHeuristic == HeuAllFinalStates,
+	"BFHS needs the all final states heuristic");
+static_assert(ParamNumThreads == 1, "BFHS is single-threaded");
+
+/* the previous, current and next layers */
+static StateSet<BFHSNode> bfhs_layers[3];
+
+/* the state that the search looks for, or nullptr for any final state */
+static const State* bfhs_target;
+
+/* sets the heuristic of s, a successor of cur_state by atom_moved if delta is
+ * true, towards the target */
+static void bfhs_heuristic(State& s, bool delta) {
+	if (bfhs_target == nullptr) {
+		if (delta) heuristic_delta(s);
+		else heuristic_initial(s);
+	} else {
+		++stat_calls_to_heuristic;
+		s.h_value = s.standard_heuristic(*bfhs_target);
+	}
+}
+
+static bool bfhs_is_target(const State& s) {
+	return bfhs_target == nullptr ? s.h_value == 0 : s == *bfhs_target;
+}
+
+/* searches breadth-first from start for the target, with the states whose f
+ * is larger than U pruned, and with the states of layer mid as relays. 
+ * mid is at least 1. returns the depth at which the target was found, or -1,
+ * and sets goal to it and relay to its relay */
+static int bfhs_search(const State& start, int U, int mid, 
+	State& goal, State& relay) {
+	auto* prev = &bfhs_layers[0];
+	auto* cur = &bfhs_layers[1];
+	auto* next = &bfhs_layers[2];
+	prev->clear();
+	cur->clear();
+	vector<BFHSNode> relays;
+
+	static State s;
+	s = start;
+	bfhs_heuristic(s, false);
+	if (bfhs_is_target(s)) {
+		goal = relay = s;
+		return 0;
+	}
+	BFHSNode n;
+	memcpy(n.v, s.v, sizeof(n.v));
+	n.relay = -1;
+	cur->insert(n);
+
+	for (int d = 0; d < U and not cur->nodes.empty(); ++d) {
+		next->clear();
+		for (size_t i = 0; i < cur->nodes.size(); ++i) {
+			if (termination_requested) return -1;
+			memcpy(s.v, cur->nodes[i].v, sizeof(s.v));
+			s.g_value = d;
+			bfhs_heuristic(s, false);
+			cur_state = &s;
+			++stat_nodes_expanded;
+
+			const Occupancy occ = occupancy(s);
+			for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+				auto atom_pos = s.v[atom_moved];
+				for (int dir = 0; dir < 4; ++dir) {
+					auto atom_pos_moved = slide(occ, atom_pos, dir);
+					if (atom_pos == atom_pos_moved) continue;
+
+					State tmp = s;
+					tmp.v[atom_moved] = atom_pos_moved;
+					tmp.g_value = d + 1;
+					if (atom_moved >= multi_start_index) {
+						int gb = group_begin[atom_moved];
+						sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+					}
+					if (prev->find(tmp.v) != -1 or cur->find(tmp.v) != -1 or
+						next->find(tmp.v) != -1) 
+						continue;
+					bfhs_heuristic(tmp, true);
+					if (tmp.f_value() > U) continue;
+					++stat_nodes_generated;
+
+					memcpy(n.v, tmp.v, sizeof(n.v));
+					n.relay = d + 1 < mid ? -1 : d + 1 == mid ? 
+						(int)relays.size() : cur->nodes[i].relay;
+					if (d + 1 == mid) relays.push_back(n);
+					if (bfhs_is_target(tmp)) {
+						goal = tmp;
+						memcpy(relay.v, relays[n.relay].v, sizeof(relay.v));
+						return d + 1;
+					}
+					next->insert(n);
+					if (prev->nodes.size() + cur->nodes.size() + 
+						next->nodes.size() + relays.size() > BFHSMaxStates)
+						throw TerminationException(
+							"Maximum number of states reached.");
+				}
+			}
+		}
+		swap(prev, cur);
+		swap(cur, next);
+	}
+	return -1;
+}
+
+/* appends to path the states after start of a shortest path from start to 
+ * target, whose length is L */
+static bool bfhs_path(const State& start, const State& target, int L,
+	vector<State>& path) {
+	if (L == 0) return true;
+	if (L == 1) {
+		path.push_back(target);
+		return true;
+	}
+	State goal, relay;
+	bfhs_target = &target;
+	int mid = L / 2;
+	if (bfhs_search(start, L, mid, goal, relay) != L) return false;
+	return bfhs_path(start, relay, mid, path) and 
+		bfhs_path(relay, target, L - mid, path);
+}
+
+vector<State> bfhs() {
+	heuristic_initial(initial_state);
+	int U = initial_state.h_value;
+	while (not termination_requested and U < GuessOnMaximumFValue) {
+		println("BFHS bound: ", U);
+		stat_lower_bound = U;
+		State goal, relay;
+		bfhs_target = nullptr;
+		int mid = (U + 1) / 2;
+		int L = bfhs_search(initial_state, U, mid, goal, relay);
+		if (L != -1) {
+			/* the smaller bounds found no path, so this one is optimal */
+			assert(L == U);
+			println("Recovering the solution path.");
+			vector<State> path = {initial_state};
+			if (L == 0 or (bfhs_path(initial_state, relay, mid, path) and 
+				bfhs_path(relay, goal, L - mid, path))) {
+				for (int i = 0; i < (int)path.size(); ++i) {
+					path[i].g_value = i;
+					heuristic_initial(path[i]);
+				}
+				reverse(path.begin(), path.end());
+				return path;
+			}
+			if (not termination_requested) 
+				println("BFHS: the solution path could not be recovered.");
+			return {};
+		}
+		++U;
+	}
+	return {};
+}
+
+#endif 
+
+} // namespace AtomixNamespace
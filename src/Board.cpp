@@ -24,16 +24,26 @@
 */
 #include "Board.h"
 #include "Atomix.h"
+#include "Print.h"
+#include <cstdlib>
 #include <queue>
 #include <ciso646>
 #include <cstring>
 
 using namespace std;
 
-char board[BoardSize];
+namespace AtomixNamespace {
+
+char board[MaxBoardSize];
+int board_free_index[MaxBoardSize];
+Pos board_free_cell[MaxBoardSize];
+vector<int> board_ray;
+int board_ray_begin[MaxBoardSize][4];
+Pos board_slide_stop[MaxBoardSize][4];
+Pos board_transpose[MaxBoardSize];
 
 void board_flood() {
-	bool visited[BoardSize]; 
+	bool visited[MaxBoardSize]; 
 	memset(visited, false, sizeof(visited));
 	queue<int> q;
 	for (auto p : initial_state.v)
@@ -49,8 +59,43 @@ void board_flood() {
 			}
 		}
 	}
+	int num_free_cells = 0;
 	for (int i = 0; i < BoardSize; ++i) {
-		if (not visited[i]) board[i] = '#';
+		board_free_index[i] = -1;
+		if (not visited[i]) {
+			board[i] = '#';
+		} else {
+			board_free_index[i] = num_free_cells;
+			board_free_cell[num_free_cells++] = i;
+		}
+	}
+	if (num_free_cells != NumFreePositions) {
+		println("Free positions found by C++: ", num_free_cells);
+		println("Free positions given by the input file: ", NumFreePositions);
+		exit(-1);
+	}
+
+	board_ray.clear();
+	for (int i = 0; i < num_free_cells; ++i) {
+		for (int d = 0; d < 4; ++d) {
+			board_ray_begin[i][d] = board_ray.size();
+			for (int p = board_free_cell[i] + PosDirections[d]; pos_valid(p); 
+				p += PosDirections[d])
+				board_ray.push_back(board_free_index[p]);
+			board_ray.push_back(-1);
+		}
+	}
+
+	for (int p = 0; p < BoardSize; ++p) {
+		board_transpose[p] = pos_c(p) * BoardHeight + pos_r(p);
+		for (int d = 0; d < 4; ++d) {
+			int x = p;
+			if (pos_valid(p))
+				while (pos_valid(x + PosDirections[d])) 
+					x += PosDirections[d];
+			board_slide_stop[p][d] = x;
+		}
 	}
 }
 
+} // namespace AtomixNamespace
@@ -26,8 +26,34 @@
 #include "Parameters.h"
 #include "Pos.h"
 #include <cctype>
+#include <vector>
 
-extern char board[BoardSize];
+namespace AtomixNamespace {
+
+extern char board[MaxBoardSize];
+
+/* board_free_index[p] is the index of position p among the free cells of the
+ * board, which are the cells reachable by atoms, and board_free_cell[i] is 
+ * the position of the free cell with index i. computed by board_flood(). 
+ * tables over positions are indexed by free cell, so that they don't hold 
+ * entries for walls */
+extern int board_free_index[MaxBoardSize];
+extern Pos board_free_cell[MaxBoardSize];
+
+/* the ray of free cell i in direction d is the list of free cell indexes that
+ * an atom at i passes over when sliding in direction d on the empty board, 
+ * in order, up to the first wall. it starts at board_ray[board_ray_begin[i][d]]
+ * and ends with -1. computed by board_flood() */
+extern std::vector<int> board_ray;
+extern int board_ray_begin[MaxBoardSize][4];
+
+/* board_slide_stop[p][d] is the position where an atom at free position p 
+ * stops when sliding in direction d on the empty board, which is p itself if
+ * there's a wall next to it. board_transpose[p] is the index of p in column
+ * major order, so that the cells of a column are consecutive (see 
+ * Occupancy.h). computed by board_flood() */
+extern Pos board_slide_stop[MaxBoardSize][4];
+extern Pos board_transpose[MaxBoardSize];
 
 inline bool board_is_wall(Pos x) {
 	return board[x] == '#';
@@ -55,3 +81,4 @@ inline void board_remove_atoms() {
 
 void board_flood();
 
+} // namespace AtomixNamespace
@@ -0,0 +1,159 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "Checkpoint.h"
+#include "Atomix.h"
+#include "Board.h"
+#include "Exceptions.h"
+#include "PDBCache.h"
+#include "Print.h"
+#include "Statistics.h"
+#include "StatesTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <ciso646>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+/* bump when the layout of the checkpoints changes */
+#define CheckpointVersion 1
+
+struct CheckpointHeader {
+	char magic[8];
+	uint64_t version, key;
+	int lower_bound;
+	double time;
+};
+
+/* the time spent by the runs that the current one continues */
+static double checkpoint_previous_time = 0.0;
+
+/* everything that the states, their heuristic values and their order in the
+ * queue depend on */
+static uint64_t checkpoint_key(int max_moves) {
+	PDBCacheKey k;
+	k.add(NumAtoms);
+	k.add(int(sizeof(State)));
+	k.add(int(sizeof(StateInfo)));
+	k.add(int(CompactStates));
+	k.add(ParamAlgorithm);
+	k.add(ParamHeuristic);
+	k.add(ParamTieBreaking);
+	k.add(ParamPDB);
+	k.add(ParamPDBGroupSize);
+	k.add(ParamPDBStorage);
+	k.add(PqSize);
+	k.add(BoardWidth);
+	k.add(BoardSize);
+	k.add(board, BoardSize);
+	k.add(initial_state.v, sizeof(initial_state.v));
+	k.add(NumFinalStates);
+	for (int f = 0; f < NumFinalStates; ++f)
+		k.add(final_states[f].v, sizeof(final_states[f].v));
+	k.add(ParamNumRandomStaticPDBs);
+#if ParamPDB == PDBStatic
+	/* the number of random PDBs that are built, which is also limited by the
+	 * memory limit */
+	k.add(int(NumRandomStaticPDBs));
+	k.add(GroupSize);
+#endif
+	k.add(ParamRandomStaticPDB);
+	k.add(ParamRandomSeed);
+	k.add(max_moves);
+	return k.h;
+}
+
+static void make_header(CheckpointHeader& h, int max_moves) {
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "atomixCK", 8);
+	h.version = CheckpointVersion;
+	h.key = checkpoint_key(max_moves);
+}
+
+void checkpoint_save(int max_moves) {
+	if (option_checkpoint_file.empty()) return;
+	/* write to a temporary file and rename it, so that a failed write keeps 
+	 * the previous checkpoint */
+	string path = ParamCheckpointFile, tmp = path + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if (f == nullptr) {
+		cerr << "Can't write checkpoint file " << tmp << "\n";
+		return;
+	}
+	CheckpointHeader h;
+	make_header(h, max_moves);
+	h.lower_bound = stat_lower_bound;
+	h.time = checkpoint_previous_time + stat_current_time();
+	StatCounters c = stat_get_counters();
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1 and 
+		fwrite(&c, sizeof(c), 1, f) == 1 and states_table.save(f);
+	ok = fclose(f) == 0 and ok;
+	if (not ok or rename(tmp.c_str(), path.c_str()) != 0) {
+		cerr << "Can't write checkpoint file " << path << "\n";
+		remove(tmp.c_str());
+		return;
+	}
+	println("Checkpoint of ", states_table.states_top - 1, " states written to ",
+		path, ".");
+}
+
+bool checkpoint_resume(int max_moves) {
+	static bool resumed = false;
+	if (option_resume_file.empty() or resumed) return false;
+	resumed = true;
+	string path = ParamResumeFile;
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == nullptr) throw FileException(path);
+	CheckpointHeader h, expected;
+	make_header(expected, max_moves);
+	if (fread(&h, sizeof(h), 1, f) != 1 or memcmp(h.magic, expected.magic, 8) 
+		or h.version != expected.version or h.key != expected.key) {
+		cerr << "The checkpoint " << path << " was written by another build, "
+			"instance or set of options, or with another number of static "
+			"PDBs, which the memory limit can change.\n";
+		exit(EXIT_FAILURE);
+	}
+	StatCounters c;
+	bool ok = fread(&c, sizeof(c), 1, f) == 1 and states_table.load(f);
+	fclose(f);
+	if (not ok) {
+		cerr << "The checkpoint " << path << " is damaged, or needs a larger "
+			"memory limit.\n";
+		exit(EXIT_FAILURE);
+	}
+	stat_add_counters(c);
+	stat_lower_bound = max(stat_lower_bound, h.lower_bound);
+	checkpoint_previous_time = h.time;
+	println("Resumed ", states_table.states_top - 1, " states from ", path, 
+		", after ", h.time, "s, with lower bound ", h.lower_bound, ".");
+	return true;
+}
+
+} // namespace AtomixNamespace
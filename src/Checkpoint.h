@@ -0,0 +1,45 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+namespace AtomixNamespace {
+
+/* checkpoints of the A* and PEA* searches, so that a search stopped by the 
+ * time or memory limit, or by a full states table, can be continued by a 
+ * later run. a checkpoint holds the states table, the search counters and 
+ * the lower bound, and is only resumed by a build with the same compile-time
+ * parameters, on the same instance and with the same PDB options. it is 
+ * enabled by --checkpoint <file> and --resume <file> (see Options.h) */
+
+/* writes the search with bound max_moves to the checkpoint file, if it is
+ * enabled */
+void checkpoint_save(int max_moves);
+
+/* if a checkpoint is to be resumed, and it hasn't been yet, loads it into 
+ * the states table, just reset by a search with bound max_moves, and returns
+ * true. exits if it doesn't belong to this search */
+bool checkpoint_resume(int max_moves);
+
+} // namespace AtomixNamespace
@@ -0,0 +1,120 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "CompactState.h"
+#include "Atomix.h"
+#include "Board.h"
+#include "Print.h"
+#include <algorithm>
+#include <ciso646>
+#include <cstdlib>
+#include <limits>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#define MaxGroupSize NumAtoms
+
+/* binomial[n][k] = C(n, k), for 0 <= n <= NumFreePositions */
+uint64_t binomial[MaxBoardSize + 1][MaxGroupSize + 1];
+
+int compact_state_bytes;
+
+/* bit offset and size of the rank of the group beginning at each atom */
+int group_bit_offset[NumAtoms], group_bits[NumAtoms];
+
+void set_bits(uint64_t* w, int offset, int bits, uint64_t x) {
+	int i = offset / 64, o = offset % 64;
+	w[i] |= x << o;
+	if (o + bits > 64) w[i + 1] |= x >> (64 - o);
+}
+
+uint64_t get_bits(const uint64_t* w, int offset, int bits) {
+	int i = offset / 64, o = offset % 64;
+	uint64_t x = w[i] >> o;
+	if (o + bits > 64) x |= w[i + 1] << (64 - o);
+	return bits == 64 ? x : x & ((1ull << bits) - 1);
+}
+
+void compact_state_init() {
+	/* saturates at the maximum value, which is never a valid rank size */
+	const auto max = numeric_limits<uint64_t>::max();
+	for (int n = 0; n <= NumFreePositions; ++n) {
+		binomial[n][0] = 1;
+		for (int k = 1; k <= MaxGroupSize; ++k) {
+			if (n == 0) {
+				binomial[n][k] = 0;
+				continue;
+			}
+			auto a = binomial[n - 1][k - 1], b = binomial[n - 1][k];
+			binomial[n][k] = (a == max or b == max or a > max - b) ? 
+				max : a + b;
+		}
+	}
+
+	int offset = 0;
+	for (int a = 0; a < NumAtoms; a += group_size[a]) {
+		auto num_ranks = binomial[NumFreePositions][group_size[a]];
+		if (num_ranks == max) {
+			println("A group of atoms does not fit in a compact state.");
+			exit(-1);
+		}
+		group_bits[a] = ceil_log2(num_ranks);
+		group_bit_offset[a] = offset;
+		offset += group_bits[a];
+	}
+	if (offset > CompactStateWords * 64) {
+		println("Atoms do not fit in a compact state.");
+		exit(-1);
+	}
+	compact_state_bytes = (offset + 7) / 8;
+	println("Compact states: ", sizeof(StateInfo) + compact_state_bytes, 
+		" bytes per state");
+}
+
+CompactState::CompactState(const State& s) {
+	memset(w, 0, sizeof(w));
+	for (int a = 0; a < NumAtoms; a += group_size[a]) {
+		uint64_t rank = 0;
+		for (int i = 0; i < group_size[a]; ++i)
+			rank += binomial[board_free_index[s.v[a + i]]][i + 1];
+		set_bits(w, group_bit_offset[a], group_bits[a], rank);
+	}
+}
+
+void CompactState::decode(State& s) const {
+	for (int a = 0; a < NumAtoms; a += group_size[a]) {
+		auto rank = get_bits(w, group_bit_offset[a], group_bits[a]);
+		int c = NumFreePositions - 1;
+		for (int i = group_size[a]; i >= 1; --i) {
+			while (binomial[c][i] > rank) --c;
+			rank -= binomial[c][i];
+			s.v[a + i - 1] = board_free_cell[c];
+			--c;
+		}
+	}
+}
+
+} // namespace AtomixNamespace
@@ -0,0 +1,78 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include "Parameters.h"
+#include <cstdint>
+#include <cstring>
+
+namespace AtomixNamespace {
+
+constexpr int ceil_log2(unsigned long long x) {
+	return x <= 1 ? 0 : 1 + ceil_log2((x + 1) / 2);
+}
+
+/* the words of a CompactState while it is encoded or decoded. a group of k
+ * atoms has fewer than 256^k ranks, so 8 bits per atom always suffice */
+#define CompactStateWords ((NumAtoms * 8 + 63) / 64)
+
+/* the number of bytes of a rank as StatesTable stores it, which is the sum 
+ * of the bits of the groups, rounded up. set by compact_state_init */
+extern int compact_state_bytes;
+
+/* the positions of the atoms of a state, as a rank over the free cells of the 
+ * board. each group of identical atoms, whose positions are sorted, is ranked 
+ * in the combinatorial number system, so a group of k atoms takes 
+ * ceil(log2(C(f, k))) bits, where f is the number of free cells. the ranks of
+ * all groups are packed one after the other into w, and only its first 
+ * compact_state_bytes bytes are stored */
+struct CompactState {
+	CompactState() = default;
+
+	explicit CompactState(const State& s);
+
+	/* reads a rank stored by store */
+	explicit CompactState(const unsigned char* p) {
+		memset(w, 0, sizeof(w));
+		memcpy(w, p, compact_state_bytes);
+	}
+
+	void store(unsigned char* p) const { memcpy(p, w, compact_state_bytes); }
+
+	bool equals(const unsigned char* p) const {
+		return memcmp(w, p, compact_state_bytes) == 0;
+	}
+
+	void decode(State& s) const;
+
+	uint64_t w[CompactStateWords];
+};
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+	"a stored rank is the first bytes of its words");
+
+void compact_state_init();
+
+} // namespace AtomixNamespace
@@ -30,6 +30,9 @@
 #define AlgIDAStar 2
 #define AlgLayeredAStar 13
 #define AlgPEAStar 14
+#define AlgExternalAStar 26
+#define AlgBFHS 27
+#define AlgMM 28
 #define HeuOneFinalState 3
 #define HeuAllFinalStates 4
 #define TBGoalCount 5
@@ -45,6 +48,9 @@
 #define PDBMultiGoal 10
 #define RandomStaticPDBRandom 21
 #define RandomStaticPDBGreedy 22
+#define PDBStorageByte 23
+#define PDBStorageNibble 24
+#define PDBStorageMin 25
 #define None 11
 
 inline const char* def_to_str(int def) {
@@ -53,6 +59,9 @@ inline const char* def_to_str(int def) {
 	case AlgIDAStar: return "IDA*";
 	case AlgLayeredAStar: return "Layered A*";
 	case AlgPEAStar: return "Partial Expansion A*";
+	case AlgExternalAStar: return "External A*";
+	case AlgBFHS: return "Breadth-First Heuristic Search";
+	case AlgMM: return "Bidirectional MM";
 	case HeuOneFinalState: return "One Final State";
 	case HeuAllFinalStates: return "All Final States";
 	case TBGoalCount: return "Goal Count";
@@ -68,6 +77,9 @@ inline const char* def_to_str(int def) {
 	case PDBMultiGoal: return "Multi-goal";
 	case RandomStaticPDBRandom: return "Random Static PDB Random";
 	case RandomStaticPDBGreedy: return "Random Static PDB Greedy";
+	case PDBStorageByte: return "Byte";
+	case PDBStorageNibble: return "Nibble";
+	case PDBStorageMin: return "Min";
 	case None: return "None";
 	default: return "None";
 	}
@@ -75,6 +87,12 @@ inline const char* def_to_str(int def) {
 
 typedef unsigned char uchar;
 
+/* the solver is built once for each number of atoms, and each build lives in 
+* its own namespace, so that all builds link into a single binary */
+#define BucketNamespace(n) BucketNamespace_(n)
+#define BucketNamespace_(n) atoms_##n
+#define AtomixNamespace BucketNamespace(NumAtoms)
+
 #define GuessOnMaximumFValue 150 /* it's a guess of the upper bound on the f-value of any instance */
 
 #define MaxNeighbours (4*NumAtoms)
@@ -25,21 +25,31 @@
 #include "DynamicPDB.h"
 #include "Parameters.h"
 #include "Atomix.h"
+#include "Board.h"
 #include "Statistics.h"
 #include "Definitions.h"
+#include "PageAlloc.h"
 #include <algorithm>
 #include <queue>
 #include <limits>
 #include <ciso646>
 #include <cstring>
 #include <cassert>
-#define GetPDB(a, b, c, d) (pdb[(int)(d) + (int)(c)*BoardSize + \
-	(int)(b)*BoardSize*BoardSize + (int)(a)*BoardSize*BoardSize*NumAtoms])
+#include <vector>
+/* pdb[a][b][c][d] is the distance of atoms a and b, in positions c and d, to
+ * their goals. positions are indexed by free cell */
+#define PDBIndex(a, b, c, d) ((((int)(a)*NumAtoms + (int)(b)) \
+	*NumFreePositions + board_free_index[(int)(c)])*NumFreePositions + \
+	board_free_index[(int)(d)])
+#define GetPDB(a, b, c, d) \
+	pdb_get(pdb, PDBIndex(a, b, c, d), DynamicPDBPacked)
+
+namespace AtomixNamespace {
 
 #if ParamPDB == PDBMultiGoal
 DynamicPDB pdb;
 #elif ParamPDB == PDBDynamic
-DynamicPDB pdb[NumFinalStates];
+DynamicPDB pdb[MaxFinalStates];
 #endif
 
 using namespace std;
@@ -58,10 +68,15 @@ void DynamicPDB::calculate(State* seeds, int num_seeds) {
 	seed = seeds[0];
 #endif
 
-	constexpr int PDBSize = NumAtoms * NumAtoms * BoardSize * BoardSize;
-	pdb = new PDBDataType[PDBSize];
-	memset(pdb, -1, PDBSize * sizeof(PDBDataType));
-	assert(pdb[0] == numeric_limits<PDBDataType>::max());
+	pdb = static_cast<PDBDataType*>(page_alloc(DynamicPDBSizeBytes));
+	memset(pdb, -1, DynamicPDBSizeBytes);
+
+	/* the distances of a pair of atoms are found in dist, which is indexed by
+	 * the free cells of both, and then stored in the table, which may be 
+	 * compressed */
+	vector<PDBDataType> dist_table(NumFreePositions * NumFreePositions);
+#define Dist(c, d) (dist_table[board_free_index[(int)(c)] * \
+	NumFreePositions + board_free_index[(int)(d)]])
 
 	static bool done[NumAtoms][NumAtoms];
 	memset(done, false, sizeof(done));
@@ -71,6 +86,14 @@ void DynamicPDB::calculate(State* seeds, int num_seeds) {
 			int gba = group_begin[a], gbb = group_begin[b];
 			if (done[gba][gbb]) continue;
 			done[gba][gbb] = done[gbb][gba] = true;
+			fill(dist_table.begin(), dist_table.end(), 
+				numeric_limits<PDBDataType>::max());
+
+			/* if a and b are identical atoms, then dist is symmetric */
+			auto set_dist = [&](int c, int d, int x) {
+				Dist(c, d) = x;
+				if (gba == gbb) Dist(d, c) = x;
+			};
 			queue<pair<int, int>> q;
 
 			for (int i = gba; i < gba + group_size[a]; ++i) {
@@ -78,13 +101,10 @@ void DynamicPDB::calculate(State* seeds, int num_seeds) {
 					if (i == j) continue;
 					for (int s = 0; s < num_seeds; ++s) {
 						int fa = seeds[s].v[i], fb = seeds[s].v[j];
-						if (GetPDB(gba, gbb, fa, fb) ==
+						if (Dist(fa, fb) ==
 							numeric_limits<PDBDataType>::max()) {
-							assert(GetPDB(gbb, gba, fb, fa) ==
-								numeric_limits<PDBDataType>::max());
 							q.emplace(fa, fb);
-							GetPDB(gba, gbb, fa, fb) = 0;
-							GetPDB(gbb, gba, fb, fa) = 0;
+							set_dist(fa, fb, 0);
 						}
 					}
 				}
@@ -98,27 +118,36 @@ void DynamicPDB::calculate(State* seeds, int num_seeds) {
 					while (true) {
 						pa2 += dir;
 						if (pa2 == pb or not pos_valid(pa2)) break;
-						int next_score = 1 + GetPDB(gba, gbb, pa, pb);
-						if (GetPDB(gba, gbb, pa2, pb) > next_score) {
-							GetPDB(gba, gbb, pa2, pb) = next_score;
-							GetPDB(gbb, gba, pb, pa2) = next_score;
+						int next_score = 1 + Dist(pa, pb);
+						if (Dist(pa2, pb) > next_score) {
+							set_dist(pa2, pb, next_score);
 							q.emplace(pa2, pb);
 						}							
 					}
 					while (true) {
 						pb2 += dir;
 						if (pb2 == pa or not pos_valid(pb2)) break;
-						int next_score = 1 + GetPDB(gba, gbb, pa, pb);
-						if (GetPDB(gba, gbb, pa, pb2) > next_score) {
-							GetPDB(gba, gbb, pa, pb2) = next_score;
-							GetPDB(gbb, gba, pb2, pa) = next_score;
+						int next_score = 1 + Dist(pa, pb);
+						if (Dist(pa, pb2) > next_score) {
+							set_dist(pa, pb2, next_score);
 							q.emplace(pa, pb2);
 						}
 					}
 				}
-			}			
+			}
+
+			for (int i = 0; i < NumFreePositions; ++i) {
+				for (int j = 0; j < NumFreePositions; ++j) {
+					int c = board_free_cell[i], d = board_free_cell[j];
+					pdb_lower(pdb, PDBIndex(gba, gbb, c, d), Dist(c, d),
+						DynamicPDBPacked);
+					pdb_lower(pdb, PDBIndex(gbb, gba, d, c), Dist(c, d),
+						DynamicPDBPacked);
+				}
+			}
 		}
 	}
+#undef Dist
 	initialize_matching();
 }
 
@@ -217,4 +246,6 @@ int DynamicPDB::min_distance_of_state_atom_to_final_states(int a,
 	return w;
 }
 
-#endif // ParamPDB == PDBDynamic || ParamPDB == PDBMultiGoals
\ No newline at end of file
+#endif // ParamPDB == PDBDynamic || ParamPDB == PDBMultiGoals
+
+} // namespace AtomixNamespace
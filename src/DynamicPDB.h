@@ -31,6 +31,14 @@
 #include "BlossomMatching/PerfectMatching.h"
 // #pragma GCC diagnostic pop
 
+namespace AtomixNamespace {
+
+/* the table has an entry for every pair of atoms and pair of free cells, 
+ * stored as set by ParamPDBStorage (see PDB.h) */
+#define DynamicPDBPacked (ParamPDBStorage == PDBStorageNibble)
+#define DynamicPDBSizeBytes pdb_table_bytes((size_t)NumAtoms * NumAtoms * \
+	NumFreePositions * NumFreePositions, DynamicPDBPacked)
+
 struct DynamicPDB {
 	void calculate(State* seeds, int num_seeds);
 	void calculate(State seed) { calculate(&seed, 1); }
@@ -61,6 +69,7 @@ struct DynamicPDB {
 #if ParamPDB == PDBMultiGoal
 extern DynamicPDB pdb;
 #elif ParamPDB == PDBDynamic
-extern DynamicPDB pdb[NumFinalStates];
+extern DynamicPDB pdb[MaxFinalStates];
 #endif
 
+} // namespace AtomixNamespace
@@ -50,16 +50,17 @@ private:
 * thrown when a file could not be opened correctly
 * */
 struct FileException : public std::exception {
-	FileException(const std::string& filename) : filename(filename) {}
+	FileException(const std::string& filename) 
+		: what_("could not open file \"" + filename + "\".") {}
 
 #if defined(_MSC_VER)
 	const char* what() const override {
 #else 
 	const char* what() const noexcept override {
 #endif
-		return std::string("could not open file \"" + filename + "\".").c_str();
+		return what_.c_str();
 	}
 
 private:
-	std::string filename;
+	std::string what_;
 	};
\ No newline at end of file
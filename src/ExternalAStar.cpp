@@ -0,0 +1,361 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "ExternalAStar.h"
+#include "AStar.h"
+#include "Atomix.h"
+#include "Exceptions.h"
+#include "Occupancy.h"
+#include "Parameters.h"
+#include "Print.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <string>
+#if defined(__unix__) || defined(__unix) || defined(unix) || \
+	(defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#define ExternalRunId (int(getpid()))
+#else 
+#define ExternalRunId 0
+#endif
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#if ParamAlgorithm == AlgExternalAStar
+
+static_assert(ParamHeuristic == HeuAllFinalStates,
+	"external A* needs the all final states heuristic");
+static_assert(ParamNumThreads == 1, "external A* is single-threaded");
+
+struct ExternalRun {
+	string path;
+	size_t records;
+};
+
+/* the runs of a bucket whose states are still to be expanded, and of those 
+ * that were */
+struct ExternalBucket {
+	vector<ExternalRun> open, closed;
+};
+
+#define Bucket(g, h) (ext_buckets[(g) * GuessOnMaximumFValue + (h)])
+
+static vector<ExternalBucket> ext_buckets;
+static vector<ExternalSuccessor> ext_buffer;
+static int ext_num_runs = 0;
+static size_t ext_disk_bytes = 0, ext_peak_disk_bytes = 0;
+
+/* reads the records of a run in blocks */
+struct ExternalReader {
+	explicit ExternalReader(const string& path) 
+		: f(fopen(path.c_str(), "rb")), buf(ExternalReadRecords) {
+		if (f == nullptr) throw FileException(path);
+		fill();
+	}
+
+	ExternalReader(const ExternalReader&) = delete;
+
+	~ExternalReader() { fclose(f); }
+
+	bool done() const { return pos == n; }
+
+	const ExternalRecord& head() const { return buf[pos]; }
+
+	void advance() {
+		if (++pos == n) fill();
+	}
+
+private:
+	void fill() {
+		n = fread(buf.data(), sizeof(ExternalRecord), buf.size(), f);
+		pos = 0;
+	}
+
+	FILE* f;
+	vector<ExternalRecord> buf;
+	size_t pos = 0, n = 0;
+};
+
+static ExternalRun ext_new_run(int g, int h) {
+	return {string(ParamExternalDir) + "/atomix-" + to_string(ExternalRunId) + 
+		"-" + to_string(g) + "-" + to_string(h) + "-" + 
+		to_string(ext_num_runs++) + ".run", 0};
+}
+
+static FILE* ext_create(const ExternalRun& run) {
+	FILE* f = fopen(run.path.c_str(), "wb");
+	if (f == nullptr) throw FileException(run.path);
+	return f;
+}
+
+static void ext_close(FILE* f, const ExternalRun& run, bool ok) {
+	ok = fclose(f) == 0 and ok;
+	if (not ok) throw TerminationException("Can't write " + run.path + ".");
+	ext_disk_bytes += run.records * sizeof(ExternalRecord);
+	ext_peak_disk_bytes = max(ext_peak_disk_bytes, ext_disk_bytes);
+}
+
+static void ext_remove(const ExternalRun& run) {
+	remove(run.path.c_str());
+	ext_disk_bytes -= run.records * sizeof(ExternalRecord);
+}
+
+static void ext_remove_all() {
+	for (auto& b : ext_buckets) {
+		for (auto& r : b.open) ext_remove(r);
+		for (auto& r : b.closed) ext_remove(r);
+		b.open.clear();
+		b.closed.clear();
+	}
+}
+
+/* writes the buffered successors, which are at depth g, as one run for each
+ * of their buckets, without the duplicates among them */
+static void ext_flush(int g) {
+	sort(ext_buffer.begin(), ext_buffer.end());
+	ext_buffer.erase(unique(ext_buffer.begin(), ext_buffer.end()), 
+		ext_buffer.end());
+	for (size_t i = 0, j; i < ext_buffer.size(); i = j) {
+		int h = ext_buffer[i].h;
+		for (j = i; j < ext_buffer.size() and ext_buffer[j].h == h; ++j) {}
+		auto run = ext_new_run(g, h);
+		FILE* f = ext_create(run);
+		bool ok = true;
+		for (size_t k = i; k < j; ++k)
+			ok = fwrite(&ext_buffer[k].r, sizeof(ExternalRecord), 1, f) == 1 
+				and ok;
+		run.records = j - i;
+		ext_close(f, run, ok);
+		Bucket(g, h).open.push_back(run);
+	}
+	ext_buffer.clear();
+}
+
+static void ext_buffer_successor(const State& s) {
+	ExternalSuccessor x;
+	x.h = s.h_value;
+	memcpy(x.r.v, s.v, sizeof(x.r.v));
+	ext_buffer.push_back(x);
+	if (ext_buffer.size() >= ExternalBufferRecords) ext_flush(s.g_value);
+}
+
+static void ext_decode(const ExternalRecord& r, int g, State& s) {
+	memcpy(s.v, r.v, sizeof(r.v));
+	s.g_value = g;
+	heuristic_initial(s);
+}
+
+/* calls visit on every successor of cur_state, with atom_moved set, until it
+ * returns true */
+template<typename Visit>
+static bool ext_for_each_successor(Visit visit) {
+	const Occupancy occ = occupancy(*cur_state);
+	for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+		auto atom_pos = cur_state->v[atom_moved];
+		for (int d = 0; d < 4; ++d) {
+			auto atom_pos_moved = slide(occ, atom_pos, d);
+			if (atom_pos == atom_pos_moved) continue;
+
+			State tmp = *cur_state;
+			tmp.v[atom_moved] = atom_pos_moved;
+			tmp.g_value = cur_state->g_value + 1;
+			if (atom_moved >= multi_start_index) {
+				int gb = group_begin[atom_moved];
+				sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+			}
+			if (visit(tmp)) return true;
+		}
+	}
+	return false;
+}
+
+static void ext_expand(const ExternalRecord& r, int g, int h) {
+	static State s;
+	ext_decode(r, g, s);
+	assert(s.h_value == h);
+	(void)h;
+	cur_state = &s;
+	++stat_nodes_expanded;
+#if StoreNodesGeneratedStats
+	++stat_nodes_expanded_with_f_value[s.f_value()];
+	++stat_nodes_expanded_with_g_value[s.g_value];
+	++stat_nodes_expanded_with_h_value[s.h_value];
+#endif
+	ext_for_each_successor([](State& tmp) {
+		heuristic_delta(tmp);
+		++stat_nodes_generated;
+#if StoreNodesGeneratedStats
+		++stat_nodes_generated_with_f_value[tmp.f_value()];
+		++stat_nodes_generated_with_g_value[tmp.g_value];
+		++stat_nodes_generated_with_h_value[tmp.h_value];
+#endif
+		if (tmp.f_value() < GuessOnMaximumFValue) ext_buffer_successor(tmp);
+		return false;
+	});
+}
+
+/* merges the open runs of bucket (g, h), and expands the states that are not
+ * in the closed runs of the buckets (g', h) with g' <= g, writing them to a 
+ * new closed run. returns true, and sets goal, when it reaches a final state */
+static bool ext_expand_bucket(int g, int h, ExternalRecord& goal) {
+	auto& B = Bucket(g, h);
+	vector<unique_ptr<ExternalReader>> open, closed;
+	for (auto& r : B.open) open.emplace_back(new ExternalReader(r.path));
+	for (int i = 0; i <= g; ++i)
+		for (auto& r : Bucket(i, h).closed) 
+			closed.emplace_back(new ExternalReader(r.path));
+
+	/* a heap of the open runs, by their first record */
+	auto later = [&](int a, int b) { return open[b]->head() < open[a]->head(); };
+	vector<int> heap;
+	for (int i = 0; i < (int)open.size(); ++i)
+		if (not open[i]->done()) heap.push_back(i);
+	make_heap(heap.begin(), heap.end(), later);
+
+	auto out = ext_new_run(g, h);
+	FILE* f = ext_create(out);
+	bool ok = true, found = false;
+	ExternalRecord r, last;
+	while (not heap.empty() and not found and not termination_requested) {
+		pop_heap(heap.begin(), heap.end(), later);
+		int i = heap.back();
+		r = open[i]->head();
+		open[i]->advance();
+		if (open[i]->done()) heap.pop_back();
+		else push_heap(heap.begin(), heap.end(), later);
+
+		if (out.records > 0 and r == last) continue;
+		bool expanded = false;
+		for (auto& c : closed) {
+			while (not c->done() and c->head() < r) c->advance();
+			expanded = expanded or (not c->done() and c->head() == r);
+		}
+		if (expanded) continue;
+
+		ok = fwrite(&r, sizeof(r), 1, f) == 1 and ok;
+		++out.records;
+		last = r;
+		if (h == 0) {
+			goal = r;
+			found = true;
+		} else {
+			ext_expand(r, g, h);
+		}
+	}
+	ext_close(f, out, ok);
+	open.clear();
+	closed.clear();
+	for (auto& run : B.open) ext_remove(run);
+	B.open.clear();
+	if (out.records > 0) B.closed.push_back(out);
+	else ext_remove(out);
+	return found;
+}
+
+/* the open bucket with the smallest f, and then g, if there is one */
+static bool ext_next_bucket(int& g, int& h) {
+	for (int f = 0; f < GuessOnMaximumFValue; ++f) {
+		for (g = 0; g <= f; ++g) {
+			h = f - g;
+			if (not Bucket(g, h).open.empty()) return true;
+		}
+	}
+	return false;
+}
+
+/* finds a state in the closed runs of layer g of which s is a successor */
+static bool ext_predecessor(const State& s, int g, State& p) {
+	const Occupancy occ = occupancy(s);
+	for (int h = 0; h + g < GuessOnMaximumFValue; ++h) {
+		for (auto& run : Bucket(g, h).closed) {
+			for (ExternalReader rd(run.path); not rd.done(); rd.advance()) {
+				/* a move changes the position of one atom */
+				int moved = 0;
+				for (int a = 0; a < NumAtoms; ++a)
+					moved += not occ.test(rd.head().v[a]);
+				if (moved != 1) continue;
+				ext_decode(rd.head(), g, p);
+				cur_state = &p;
+				if (ext_for_each_successor([&](State& t) { return t == s; }))
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+static vector<State> ext_solution_path(const ExternalRecord& goal, int g) {
+	vector<State> path(g + 1);
+	ext_decode(goal, g, path[0]);
+	for (int i = 1; i <= g; ++i) {
+		if (not ext_predecessor(path[i - 1], g - i, path[i])) {
+			println("External A*: no predecessor found for the solution path.");
+			return {};
+		}
+	}
+	return path;
+}
+
+vector<State> external_a_star() {
+	ext_buckets.assign(GuessOnMaximumFValue * GuessOnMaximumFValue, 
+		ExternalBucket());
+	ext_buffer.reserve(ExternalBufferRecords);
+	println("External A* in ", ParamExternalDir, ", buffering ", 
+		ExternalBufferRecords, " states");
+	vector<State> path;
+	try {
+		heuristic_initial(initial_state);
+		initial_state.g_value = 0;
+		ext_buffer_successor(initial_state);
+		ext_flush(0);
+
+		int g, h;
+		while (not termination_requested and ext_next_bucket(g, h)) {
+			stat_lower_bound = max(stat_lower_bound, g + h);
+			ExternalRecord goal;
+			bool found = ext_expand_bucket(g, h, goal);
+			ext_flush(g + 1);
+			if (found) {
+				path = ext_solution_path(goal, g);
+				break;
+			}
+		}
+	} catch (...) {
+		ext_remove_all();
+		throw;
+	}
+	println("External A*: peak disk usage of ", 
+		ext_peak_disk_bytes / (1024 * 1024), " MB");
+	ext_remove_all();
+	return path;
+}
+
+#endif 
+
+} // namespace AtomixNamespace
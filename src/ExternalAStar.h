@@ -0,0 +1,78 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include "StatesTable.h"
+#include <cstring>
+#include <vector>
+#include <ciso646>
+
+namespace AtomixNamespace {
+
+/* external-memory A* with delayed duplicate detection (Edelkamp, Jabbar and 
+ * Schroedl, 2004). the states are kept on disk, in sorted run files of their 
+ * positions under the directory given by --extdir, in one bucket per pair 
+ * (g, h). the open bucket with the smallest (f, g) is expanded by merging its
+ * runs, which removes the duplicates within it, and subtracting the closed 
+ * runs of the buckets (g', h) with g' <= g, since a state always has the same
+ * h. the successors are buffered in memory, and written as new runs of the 
+ * buckets (g + 1, h') when the buffer is full. the solution path is found 
+ * backwards, by searching the closed runs of each layer for a predecessor */
+
+/* the successors buffered before they are written... */
+#define ExternalBufferRecords (MemoryForStates / 2 / sizeof(ExternalSuccessor))
+/* ...and the records read at once from each run */
+#define ExternalReadRecords 4096
+
+/* the runs hold the positions of the states, sorted bytewise */
+struct ExternalRecord {
+	bool operator<(const ExternalRecord& r) const {
+		return memcmp(v, r.v, sizeof(v)) < 0;
+	}
+
+	bool operator==(const ExternalRecord& r) const {
+		return memcmp(v, r.v, sizeof(v)) == 0;
+	}
+
+	Pos v[NumAtoms];
+};
+
+/* a buffered successor, sorted by the bucket it goes to */
+struct ExternalSuccessor {
+	bool operator<(const ExternalSuccessor& s) const {
+		return h != s.h ? h < s.h : r < s.r;
+	}
+
+	bool operator==(const ExternalSuccessor& s) const {
+		return h == s.h and r == s.r;
+	}
+
+	unsigned char h;
+	ExternalRecord r;
+};
+
+std::vector<State> external_a_star();
+
+} // namespace AtomixNamespace
@@ -0,0 +1,467 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "HDAStar.h"
+#include "AStar.h"
+#include "Atomix.h"
+#include "Occupancy.h"
+#include "Parameters.h"
+#include "Print.h"
+#include "Statistics.h"
+#include "StatesTable.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <ciso646>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#if ParamNumThreads > 1
+
+static_assert(ParamAlgorithm == AlgAStar || ParamAlgorithm == AlgPEAStar,
+	"HDA* is only implemented for A* and PEA*.");
+static_assert(ParamHeuristic == HeuAllFinalStates,
+	"HDA* is only implemented for the all final states heuristic.");
+static_assert(ParamPDB != PDBDynamic && ParamPDB != PDBMultiGoal,
+	"Dynamic PDBs share a single matching solver between threads.");
+static_assert(ParamTieBreaking != TBRandom,
+	"Random tie-breaking shares a single random number generator between "
+	"threads.");
+static_assert(SaveSolutionPath, "");
+
+/* parents are stored as global indexes, which also tell the worker that owns
+ * the parent */
+#define HDAGlobalIndex(i, w) ((i) * ParamNumThreads + (w))
+#define HDALocalIndex(i) ((i) / ParamNumThreads)
+#define HDAWorkerOf(i) ((i) % ParamNumThreads)
+
+struct HDABatch {
+	HDABatch* next = nullptr;
+	int size = 0;
+	State states[HDABatchSize];
+};
+
+struct HDAWorker {
+	StatesTable tb;
+
+	/* lock-free stack of batches sent to this worker. the worker takes the 
+	 * whole stack at once, so there is no ABA problem */
+	atomic<HDABatch*> inbox{nullptr};
+
+	/* batches being filled for each of the other workers */
+	HDABatch* outbox[ParamNumThreads] = {};
+
+	/* copy of the state being expanded */
+	State cur;
+
+#if ParamAlgorithm == AlgPEAStar
+	State neighbours[MaxNeighbours];
+	Index neighbours_hash_indexes[MaxNeighbours];
+	int neighbours_owner[MaxNeighbours];
+#endif 
+
+	StatCounters counters;
+};
+
+unique_ptr<HDAWorker> hda_workers[ParamNumThreads];
+
+/* states with f >= hda_incumbent cannot improve the best solution found */
+atomic<int> hda_incumbent;
+
+/* number of active workers plus number of batches sent but not yet 
+ * processed. the search is over when it reaches zero */
+atomic<int> hda_pending;
+
+mutex hda_solution_mutex;
+bool hda_solution_found = false;
+State hda_solution;
+exception_ptr hda_exception;
+
+/* the owner of a state with hash h. the hash is mixed again, so that the 
+ * owner of a state does not depend on the slot it takes in its owner's hash 
+ * table */
+int hda_owner(size_t h) {
+	return ((h * 0x9E3779B97F4A7C15ull) >> 32) % ParamNumThreads;
+}
+
+void hda_record_solution(const State& s) {
+	lock_guard<mutex> lock(hda_solution_mutex);
+	if (s.g_value < hda_incumbent) {
+		hda_incumbent = s.g_value;
+		hda_solution = s;
+		hda_solution_found = true;
+	}
+}
+
+void hda_flush(HDAWorker& w, int to) {
+	auto b = w.outbox[to];
+	if (b == nullptr) return;
+	w.outbox[to] = nullptr;
+	++hda_pending;
+	auto& inbox = hda_workers[to]->inbox;
+	b->next = inbox.load(memory_order_relaxed);
+	while (not inbox.compare_exchange_weak(b->next, b, memory_order_release,
+		memory_order_relaxed));
+}
+
+void hda_flush_all(HDAWorker& w) {
+	for (int i = 0; i < ParamNumThreads; ++i)
+		hda_flush(w, i);
+}
+
+void hda_send(HDAWorker& w, int to, const State& s) {
+	auto& b = w.outbox[to];
+	if (b == nullptr) b = new HDABatch;
+	b->states[b->size++] = s;
+	if (b->size == HDABatchSize) hda_flush(w, to);
+}
+
+/* stores s in w's table, given that s is owned by w and that i is the result
+ * of looking it up there */
+void hda_store(HDAWorker& w, const State& s, Index i) {
+	auto& tb = w.tb;
+	if (i == -1) {
+		tb.pq_push(tb.insert(s));
+	} else {
+		assert(s.g_value < tb.info(i).g_value);
+		tb.pq_update(i, s.g_value);
+		tb.info(i).parent = s.parent;
+#if ParamAlgorithm == AlgPEAStar
+		tb.info(i).pea_F = 0;
+#endif 
+	}
+}
+
+void hda_receive(HDAWorker& w) {
+	auto& tb = w.tb;
+	auto b = w.inbox.exchange(nullptr, memory_order_acquire);
+	while (b != nullptr) {
+		for (int j = 0; j < b->size; ++j) {
+			auto& s = b->states[j];
+			if (s.f_value() >= hda_incumbent) continue;
+			Index i = tb.hash_find(s);
+			if (i == -1 or s.g_value < tb.info(i).g_value)
+				hda_store(w, s, i);
+		}
+		auto next = b->next;
+		delete b;
+		b = next;
+		--hda_pending;
+	}
+}
+
+/* called when w has no state with f < hda_incumbent left. returns true if w
+ * received more states, and false if the search is over */
+bool hda_wait(HDAWorker& w) {
+	hda_flush_all(w);
+	--hda_pending;
+	while (not termination_requested) {
+		if (w.inbox.load(memory_order_acquire) != nullptr) {
+			++hda_pending;
+			return true;
+		}
+		if (hda_pending == 0) return false;
+		this_thread::yield();
+	}
+	return false;
+}
+
+#if ParamAlgorithm != AlgPEAStar
+void hda_expand(HDAWorker& w, int id, Index s) {
+	auto& tb = w.tb;
+	w.cur = tb.get_state(s);
+	cur_state = &w.cur;
+	const Occupancy occ = occupancy(*cur_state);
+	const size_t cur_hash = cur_state->get_hash();
+	for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+		auto atom_pos = cur_state->v[atom_moved];
+		for (int d = 0; d < 4; ++d) {
+			auto atom_pos_moved = slide(occ, atom_pos, d);
+
+			if (atom_pos == atom_pos_moved) {
+				continue;
+			}
+
+			State tmp = *cur_state;
+			tmp.v[atom_moved] = atom_pos_moved;
+			tmp.g_value = cur_state->g_value + 1;
+			tmp.parent = HDAGlobalIndex(s, id);
+
+			if (atom_moved >= multi_start_index) {
+				int gb = group_begin[atom_moved];
+				sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+			}
+			size_t hash = hash_move(cur_hash, atom_moved, atom_pos, atom_pos_moved);
+			assert(hash == tmp.get_hash());
+
+			int owner = hda_owner(hash);
+			Index i = -1;
+			if (owner == id) {
+				i = tb.hash_find(tmp, hash);
+				if (i != -1 and tmp.g_value >= tb.info(i).g_value) continue;
+			}
+			if (i == -1) {
+				heuristic_delta(tmp);
+			} else {
+				tmp.h_value = tb.info(i).h_value;
+			}
+
+			if (tmp.h_value == 0) {
+				hda_record_solution(tmp);
+				continue;
+			}
+			if (tmp.f_value() >= hda_incumbent) continue;
+
+			if (owner == id) {
+				hda_store(w, tmp, i);
+			} else {
+				hda_send(w, owner, tmp);
+			}
+		}
+	}
+}
+#else 
+void hda_expand(HDAWorker& w, int id, Index s) {
+	auto& tb = w.tb;
+	int num_neighbours = 0;
+	int min_neighbours_f_value = numeric_limits<int>::max();
+	int next_pea_F = numeric_limits<int>::max();
+	w.cur = tb.get_state(s);
+	cur_state = &w.cur;
+
+	const Occupancy occ = occupancy(*cur_state);
+	const size_t cur_hash = cur_state->get_hash();
+	for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+		auto atom_pos = cur_state->v[atom_moved];
+		for (int d = 0; d < 4; ++d) {
+			auto atom_pos_moved = slide(occ, atom_pos, d);
+
+			if (atom_pos == atom_pos_moved) {
+				continue;
+			}
+
+			State& tmp = w.neighbours[num_neighbours];
+			tmp = *cur_state;
+			tmp.v[atom_moved] = atom_pos_moved;
+			tmp.g_value = cur_state->g_value + 1;
+			tmp.parent = HDAGlobalIndex(s, id);
+			tmp.pea_F = 0;
+
+			if (atom_moved >= multi_start_index) {
+				int gb = group_begin[atom_moved];
+				sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+			}
+			size_t hash = hash_move(cur_hash, atom_moved, atom_pos, atom_pos_moved);
+			assert(hash == tmp.get_hash());
+
+			int owner = hda_owner(hash);
+			Index i = -1;
+			if (owner == id) {
+				i = tb.hash_find(tmp, hash);
+				if (i != -1 and tmp.g_value >= tb.info(i).g_value) continue;
+			}
+			if (i == -1) {
+				heuristic_delta(tmp);
+			} else {
+				tmp.h_value = tb.info(i).h_value;
+				tmp.std_h_value = tb.info(i).std_h_value;
+				tmp.tie_breaker = tb.info(i).tie_breaker;
+			}
+
+			if (tmp.h_value == 0) {
+				hda_record_solution(tmp);
+				continue;
+			}
+			int tmp_f = tmp.f_value();
+			if (tmp_f >= hda_incumbent or tmp_f < cur_state->pea_F) continue;
+
+			w.neighbours_hash_indexes[num_neighbours] = i;
+			w.neighbours_owner[num_neighbours] = owner;
+			min_neighbours_f_value = min(min_neighbours_f_value, tmp_f);
+			++num_neighbours;
+		}
+	}
+
+	/* send the neighbours with minimum f, if it is not larger than the f of
+	 * the current state, and reinsert the current state with the next f */
+	if (min_neighbours_f_value > cur_state->f_value())
+		min_neighbours_f_value = -1;
+
+	for (int j = 0; j < num_neighbours; ++j) {
+		auto& tmp = w.neighbours[j];
+		int tmp_f = tmp.f_value();
+		if (tmp_f != min_neighbours_f_value) {
+			next_pea_F = min(next_pea_F, tmp_f);
+		} else if (w.neighbours_owner[j] == id) {
+			hda_store(w, tmp, w.neighbours_hash_indexes[j]);
+		} else {
+			hda_send(w, w.neighbours_owner[j], tmp);
+		}
+	}
+
+	if (next_pea_F != numeric_limits<int>::max()) {
+		tb.info(s).pea_F = next_pea_F;
+		tb.info(s).h_value = next_pea_F - cur_state->g_value;
+		tb.pq_push(s);
+		++stat_num_reopened_states;
+	}
+}
+#endif // ParamAlgorithm != AlgPEAStar
+
+void hda_worker(int id) {
+	auto& w = *hda_workers[id];
+	int num_expanded = 0;
+	try {
+		w.tb.reset(MaxStates / ParamNumThreads);
+		while (not termination_requested) {
+			hda_receive(w);
+
+			int f = w.tb.pq_min_f();
+			if (f == -1 or f >= hda_incumbent) {
+				if (hda_wait(w)) continue;
+				break;
+			}
+
+			Index s = w.tb.pq_pop();
+#if StoreNodesGeneratedStats
+			++stat_nodes_expanded_with_f_value[w.tb.info(s).f_value()];
+			++stat_nodes_expanded_with_g_value[w.tb.info(s).g_value];
+			++stat_nodes_expanded_with_h_value[w.tb.info(s).h_value];
+#endif
+			hda_expand(w, id, s);
+
+			if (++num_expanded % HDAFlushInterval == 0)
+				hda_flush_all(w);
+		}
+	} catch (...) {
+		lock_guard<mutex> lock(hda_solution_mutex);
+		if (hda_exception == nullptr) 
+			hda_exception = current_exception();
+		termination_requested = true;
+	}
+	w.counters = stat_get_counters();
+}
+
+/* the smallest f of the states left in w, including the ones in batches */
+int hda_min_f(HDAWorker& w) {
+	int f = w.tb.pq == nullptr ? -1 : w.tb.pq_min_f();
+	if (f == -1) f = numeric_limits<int>::max();
+
+	auto min_f_batch = [&](HDABatch* b) {
+		for (; b != nullptr; b = b->next)
+			for (int j = 0; j < b->size; ++j)
+				f = min(f, (int)b->states[j].f_value());
+	};
+	min_f_batch(w.inbox.load());
+	for (auto b : w.outbox) min_f_batch(b);
+	return f;
+}
+
+void hda_free_batches(HDAWorker& w) {
+	auto free_batches = [](HDABatch* b) {
+		while (b != nullptr) {
+			auto next = b->next;
+			delete b;
+			b = next;
+		}
+	};
+	free_batches(w.inbox.exchange(nullptr));
+	for (auto& b : w.outbox) {
+		free_batches(b);
+		b = nullptr;
+	}
+}
+
+vector<State> hda_star(int max_moves) {
+	hda_incumbent = max_moves == numeric_limits<int>::max() ? 
+		max_moves : max_moves + 1;
+	hda_pending = ParamNumThreads;
+	hda_solution_found = false;
+	hda_exception = nullptr;
+	for (auto& w : hda_workers) w.reset(new HDAWorker);
+
+	heuristic_initial(initial_state);
+	initial_state.g_value = 0;
+	initial_state.parent = -1;
+#if ParamAlgorithm == AlgPEAStar
+	initial_state.pea_F = 0;
+#endif 
+	if (initial_state.h_value == 0) {
+		return {initial_state};
+	}
+
+	auto b = new HDABatch;
+	b->states[b->size++] = initial_state;
+	hda_workers[hda_owner(initial_state.get_hash())]->inbox = b;
+	++hda_pending;
+
+	println("Running HDA* with ", ParamNumThreads, " threads.");
+	vector<thread> threads;
+	for (int i = 0; i < ParamNumThreads; ++i)
+		threads.emplace_back(hda_worker, i);
+	for (auto& t : threads)
+		t.join();
+
+	int min_f = numeric_limits<int>::max();
+	for (auto& w : hda_workers) {
+		stat_add_counters(w->counters);
+		min_f = min(min_f, hda_min_f(*w));
+		hda_free_batches(*w);
+	}
+	min_f = min(min_f, (int)hda_incumbent);
+	if (min_f != numeric_limits<int>::max())
+		stat_lower_bound = max(stat_lower_bound, min_f);
+
+	vector<State> path;
+	if (hda_exception == nullptr and hda_solution_found) {
+		path.push_back(hda_solution);
+		for (Index p = hda_solution.parent; p != -1;) {
+			auto s = hda_workers[HDAWorkerOf(p)]->tb.get_state(HDALocalIndex(p));
+			path.push_back(s);
+			p = s.parent;
+		}
+	}
+	for (auto& w : hda_workers) w.reset();
+
+	if (hda_exception != nullptr)
+		rethrow_exception(hda_exception);
+	return path;
+}
+
+#else 
+
+vector<State> hda_star(int) {
+	return {};
+}
+
+#endif // ParamNumThreads > 1
+
+} // namespace AtomixNamespace
@@ -0,0 +1,45 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include <limits>
+#include <vector>
+
+namespace AtomixNamespace {
+
+/* hash-distributed A* (Kishimoto, Fukunaga and Botea, 2009). each of the 
+ * ParamNumThreads workers owns the states whose hash maps to it, keeping them 
+ * in its own StatesTable, and sends every successor it generates to the 
+ * successor's owner. with ParamAlgorithm == AlgPEAStar the workers do partial
+ * expansion, as expand_node does */
+
+/* states are sent in batches of this size... */
+#define HDABatchSize 256
+/* ...and partially filled batches are sent after this many expansions */
+#define HDAFlushInterval 32
+
+std::vector<State> hda_star(int max_moves = std::numeric_limits<int>::max());
+
+} // namespace AtomixNamespace
@@ -0,0 +1,211 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "IDAStar.h"
+#include "AStar.h"
+#include "Atomix.h"
+#include "Occupancy.h"
+#include "OneFinalState.h"
+#include "Parameters.h"
+#include "Print.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <ciso646>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace AtomixNamespace {
+
+#if ParamAlgorithm == AlgIDAStar
+
+int ida_threshold, ida_next_threshold;
+unsigned short ida_iteration = 0;
+int ida_solution_depth = -1;
+
+/* ida_path[d] is the state at depth d of the current path, and 
+ * ida_neighbours[d] are its neighbours */
+State ida_path[GuessOnMaximumFValue + 1];
+State ida_neighbours[GuessOnMaximumFValue][MaxNeighbours];
+
+#if IDAStarTranspositionTable
+IDAStarTTEntry* ida_tt = nullptr;
+
+/* returns true if s was already reached in this iteration with a g-value 
+ * not larger than its own; otherwise, stores s in the table */
+bool ida_tt_visited(const State& s) {
+	auto& e = ida_tt[s.get_hash() % IDAStarTTSize];
+	if (e.iteration == ida_iteration and
+		memcmp(e.v, s.v, NumAtoms * sizeof(Pos)) == 0) {
+		if (e.g_value <= s.g_value) return true;
+		e.g_value = s.g_value;
+		return false;
+	}
+	memcpy(e.v, s.v, NumAtoms * sizeof(Pos));
+	e.g_value = s.g_value;
+	e.iteration = ida_iteration;
+	return false;
+}
+#endif 
+
+bool ida_dfs(int depth) {
+	if (termination_requested) return false;
+	++stat_nodes_expanded;
+
+	int num_neighbours = 0;
+	auto neighbours = ida_neighbours[depth];
+	cur_state = &ida_path[depth];
+
+	const Occupancy occ = occupancy(*cur_state);
+	for (atom_moved = 0; atom_moved < NumAtoms; ++atom_moved) {
+		auto atom_pos = cur_state->v[atom_moved];
+		for (int d = 0; d < 4; ++d) {
+			auto atom_pos_moved = slide(occ, atom_pos, d);
+
+			if (atom_pos == atom_pos_moved) {
+				continue;
+			}
+
+			State& tmp = neighbours[num_neighbours];
+			tmp = *cur_state;
+			tmp.v[atom_moved] = atom_pos_moved;
+			tmp.g_value = cur_state->g_value + 1;
+
+			if (atom_moved >= multi_start_index) {
+				int gb = group_begin[atom_moved];
+				sort(&tmp.v[0] + gb, &tmp.v[0] + gb + group_size[gb]);
+			}
+
+			/* do not move back to the parent */
+			if (depth > 0 and tmp == ida_path[depth - 1]) continue;
+
+			heuristic_delta(tmp);
+			++stat_nodes_generated;
+
+			int tmp_f = tmp.f_value();
+			if (tmp_f > ida_threshold) {
+				ida_next_threshold = min(ida_next_threshold, tmp_f);
+				continue;
+			}
+			if (tmp.h_value == 0) {
+				ida_path[depth + 1] = tmp;
+				ida_solution_depth = depth + 1;
+				return true;
+			}
+			++num_neighbours;
+		}
+	}
+
+	/* visit the best neighbours first, so that the last iteration ends early */
+	sort(neighbours, neighbours + num_neighbours, 
+		[](const State& a, const State& b) {
+		if (a.f_value() != b.f_value()) return a.f_value() < b.f_value();
+		return a.tie_breaker > b.tie_breaker;
+	});
+
+	for (int i = 0; i < num_neighbours; ++i) {
+#if IDAStarTranspositionTable
+		if (ida_tt_visited(neighbours[i])) continue;
+#endif 
+		ida_path[depth + 1] = neighbours[i];
+		if (ida_dfs(depth + 1)) return true;
+		if (termination_requested) return false;
+	}
+	return false;
+}
+
+bool ida_star_iteration() {
+#if IDAStarTranspositionTable
+	if (++ida_iteration == 0) {
+		memset(ida_tt, 0, IDAStarTTSize * sizeof(IDAStarTTEntry));
+		ida_iteration = 1;
+	}
+#endif 
+	heuristic_initial(initial_state);
+	initial_state.g_value = 0;
+	ida_path[0] = initial_state;
+	if (initial_state.h_value == 0) {
+		ida_solution_depth = 0;
+		return true;
+	}
+	if (initial_state.f_value() > ida_threshold) {
+		ida_next_threshold = min(ida_next_threshold, 
+			(int)initial_state.f_value());
+		return false;
+	}
+#if IDAStarTranspositionTable
+	ida_tt_visited(initial_state);
+#endif 
+	return ida_dfs(0);
+}
+
+vector<State> ida_star() {
+#if IDAStarTranspositionTable
+	if (ida_tt == nullptr) {
+		ida_tt = new IDAStarTTEntry[IDAStarTTSize];
+		memset(ida_tt, 0, IDAStarTTSize * sizeof(IDAStarTTEntry));
+	}
+#endif 
+	ida_solution_depth = -1;
+	ida_threshold = calc_initial_heuristic();
+	while (not termination_requested) {
+		println("IDA* threshold: ", ida_threshold);
+		stat_lower_bound = ida_threshold;
+		ida_next_threshold = numeric_limits<int>::max();
+		auto old_nodes_generated = stat_nodes_generated;
+		bool found = false;
+#if ParamHeuristic == HeuOneFinalState
+		for (int i = 0; i < NumFinalStates and not found; ++i) {
+			single_final_state_index = i;
+			single_final_state = final_states[i];
+			found = ida_star_iteration();
+		}
+#elif ParamHeuristic == HeuAllFinalStates
+		found = ida_star_iteration();
+#endif 
+		stat_nodes_generated_at_depth[ida_threshold] += stat_nodes_generated 
+			- old_nodes_generated;
+		if (found) {
+			return vector<State>(
+				make_reverse_iterator(ida_path + ida_solution_depth + 1),
+				make_reverse_iterator(ida_path));
+		}
+		if (ida_next_threshold == numeric_limits<int>::max() or 
+			ida_next_threshold >= GuessOnMaximumFValue) 
+			break;
+		ida_threshold = ida_next_threshold;
+	}
+	return {};
+}
+
+#else 
+
+vector<State> ida_star() {
+	return {};
+}
+
+#endif // ParamAlgorithm == AlgIDAStar
+
+} // namespace AtomixNamespace
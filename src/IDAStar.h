@@ -0,0 +1,48 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include "StatesTable.h"
+#include <vector>
+
+namespace AtomixNamespace {
+
+/* IDA* keeps only the current path in memory. optionally, it uses a 
+ * transposition table of fixed size, which stores the smallest g-value with 
+ * which each state was reached in the current iteration, so that states 
+ * reached again with a larger or equal g-value are pruned. when two states 
+ * map to the same entry, the newest one replaces the other */
+#define IDAStarTranspositionTable true
+#define IDAStarTTSize (size_t(MemoryForStates * 0.75 / sizeof(IDAStarTTEntry)))
+
+struct IDAStarTTEntry {
+	Pos v[NumAtoms];
+	unsigned char g_value;
+	unsigned short iteration;
+};
+
+std::vector<State> ida_star();
+
+} // namespace AtomixNamespace
@@ -0,0 +1,92 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "Instance.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <ciso646>
+
+using namespace std;
+
+string instance_name, instance_board, instance_mole;
+int instance_num_atoms = 0, instance_num_final_states = 0;
+int instance_board_width = 0, instance_board_height = 0, instance_board_size = 0;
+int instance_mole_width = 0, instance_mole_height = 0, instance_mole_size = 0;
+int instance_num_free_positions = 0;
+
+bool read_instance(const string& path) {
+	ifstream f(path);
+	if (not f) {
+		cerr << "Can't open input file " << path << ".\n";
+		return false;
+	}
+	vector<string> lines;
+	for (string l; getline(f, l);) {
+		while (l.size() and (l.back() == '\r' or l.back() == '\n'))
+			l.pop_back();
+		lines.push_back(l);
+	}
+
+	/* name, number of atoms, board size and board, mole size and mole, 
+	 * number of final states and number of free positions */
+	size_t i = 0;
+	auto next = [&]() { return i < lines.size() ? lines[i++] : string(); };
+	instance_name = next();
+	istringstream(next()) >> instance_num_atoms;
+	istringstream(next()) >> instance_board_width >> instance_board_height;
+	instance_board.clear();
+	for (int r = 0; r < instance_board_height; ++r)
+		instance_board += next();
+	istringstream(next()) >> instance_mole_width >> instance_mole_height;
+	instance_mole.clear();
+	for (int r = 0; r < instance_mole_height; ++r)
+		instance_mole += next();
+	istringstream(next()) >> instance_num_final_states;
+	istringstream(next()) >> instance_num_free_positions;
+
+	instance_board_size = instance_board_width * instance_board_height;
+	instance_mole_size = instance_mole_width * instance_mole_height;
+
+	if (instance_num_atoms <= 0 or instance_board_size <= 0 or 
+		instance_mole_size <= 0 or 
+		(int)instance_board.size() != instance_board_size or
+		(int)instance_mole.size() != instance_mole_size) {
+		cerr << "Input file " << path << " is not a valid instance.\n";
+		return false;
+	}
+	if (instance_board_size > MaxBoardSize) {
+		cerr << "Board has " << instance_board_size << " positions, but at "
+			"most " << MaxBoardSize << " are supported.\n";
+		return false;
+	}
+	if (instance_num_final_states < 1 or 
+		instance_num_final_states > MaxFinalStates) {
+		cerr << "Instance has " << instance_num_final_states << " final "
+			"states, but at most " << MaxFinalStates << " are supported.\n";
+		return false;
+	}
+	return true;
+}
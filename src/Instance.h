@@ -0,0 +1,53 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include <string>
+
+/* the instance is read at runtime from the input file, so that one build of 
+ * the solver (one per number of atoms, see the Makefile) solves any board. 
+ * arrays indexed by position or by final state are sized by the maxima below */
+#define MaxBoardSize 256
+#define MaxFinalStates 64
+
+#define NumFinalStates instance_num_final_states
+#define BoardWidth instance_board_width
+#define BoardHeight instance_board_height
+#define BoardSize instance_board_size
+#define MoleWidth instance_mole_width
+#define MoleHeight instance_mole_height
+#define MoleSize instance_mole_size
+#define NumFreePositions instance_num_free_positions
+#define ParamBoard (instance_board.c_str())
+#define ParamMole (instance_mole.c_str())
+
+extern std::string instance_name, instance_board, instance_mole;
+extern int instance_num_atoms, instance_num_final_states;
+extern int instance_board_width, instance_board_height, instance_board_size;
+extern int instance_mole_width, instance_mole_height, instance_mole_size;
+extern int instance_num_free_positions;
+
+/* reads an instance in the format of the files in instances/. returns false, 
+ * after printing the reason, if the file can't be read or is too large */
+bool read_instance(const std::string& path);
@@ -24,15 +24,18 @@
 */
 #include "MinCostBipartiteMatching.h"
 #include "Definitions.h"
+#include "State.h"
 #include <algorithm>
 #include <vector>
 #include <cstring>
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 int min_cost_bipartite_matching(int cost[NumAtoms][NumAtoms], int Lmate[NumAtoms], 
 	int Rmate[NumAtoms], int n) {
-	static int dist[NumAtoms], dad[NumAtoms], seen[NumAtoms],
+	static SearchThreadLocal int dist[NumAtoms], dad[NumAtoms], seen[NumAtoms],
 		u[NumAtoms], v[NumAtoms];
 	memset(Lmate, -1, (n + 1) * sizeof(int));
 	memset(Rmate, -1, (n + 1) * sizeof(int));
@@ -107,3 +110,4 @@ int min_cost_bipartite_matching(int cost[NumAtoms][NumAtoms], int Lmate[NumAtoms
 	return value;
 }
 
+} // namespace AtomixNamespace
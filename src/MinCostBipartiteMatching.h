@@ -25,5 +25,9 @@
 #pragma once
 #include "Parameters.h"
 
+namespace AtomixNamespace {
+
 int min_cost_bipartite_matching(int cost[NumAtoms][NumAtoms], int Lmate[NumAtoms], 
-	int Rmate[NumAtoms], int n);
\ No newline at end of file
+	int Rmate[NumAtoms], int n);
+
+} // namespace AtomixNamespace
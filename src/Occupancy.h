@@ -0,0 +1,127 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "Parameters.h"
+#include "Board.h"
+#include "State.h"
+#include <ciso646>
+#include <cstdint>
+#include <cstring>
+
+namespace AtomixNamespace {
+
+/* the occupancy of a state is a bitboard of the positions of its atoms, 
+ * which fits in 4 64-bit words because BoardSize <= 256. it is kept both in 
+ * row major order (rows) and column major order (cols, indexed by 
+ * board_transpose), so that the cells an atom passes over when sliding are
+ * consecutive bits in either order. it costs one pass over the atoms to 
+ * build, after which every occupancy query on the state is a word operation,
+ * so code that asks many of them about one state should build it once */
+struct Occupancy {
+	uint64_t rows[4], cols[4];
+
+	void set(Pos p) {
+		rows[p >> 6] |= uint64_t(1) << (p & 63);
+		Pos t = board_transpose[p];
+		cols[t >> 6] |= uint64_t(1) << (t & 63);
+	}
+
+	bool test(Pos p) const {
+		return rows[p >> 6] >> (p & 63) & 1;
+	}
+
+	bool is_obstacle(Pos p) const {
+		return board_is_wall(p) or test(p);
+	}
+};
+
+inline Occupancy occupancy(const State& s) {
+	Occupancy o;
+	memset(&o, 0, sizeof(o));
+	for (int i = 0; i < NumAtoms; ++i)
+		o.set(s.v[i]);
+	return o;
+}
+
+/* the first set bit of b in [lo, hi], or -1 if there's none */
+inline int bits_first(const uint64_t* b, int lo, int hi) {
+	for (int w = lo >> 6; w <= hi >> 6; ++w) {
+		uint64_t x = b[w];
+		if (w == lo >> 6) x &= ~uint64_t(0) << (lo & 63);
+		if (w == hi >> 6) x &= ~uint64_t(0) >> (63 - (hi & 63));
+		if (x) return w * 64 + __builtin_ctzll(x);
+	}
+	return -1;
+}
+
+/* the last set bit of b in [lo, hi], or -1 if there's none */
+inline int bits_last(const uint64_t* b, int lo, int hi) {
+	for (int w = hi >> 6; w >= lo >> 6; --w) {
+		uint64_t x = b[w];
+		if (w == lo >> 6) x &= ~uint64_t(0) << (lo & 63);
+		if (w == hi >> 6) x &= ~uint64_t(0) >> (63 - (hi & 63));
+		if (x) return w * 64 + 63 - __builtin_clzll(x);
+	}
+	return -1;
+}
+
+/* the position where an atom at p stops when sliding in direction d (see 
+ * Dir), in a state with occupancy o: the wall-limited stop of the empty 
+ * board, clipped before the nearest atom in the way */
+inline Pos slide(const Occupancy& o, Pos p, int d) {
+	int stop = board_slide_stop[p][d], q;
+	if (stop == p) return p;
+	switch (d) {
+	case Dir::Right:
+		q = bits_first(o.rows, p + 1, stop);
+		return q == -1 ? stop : q - 1;
+	case Dir::Left:
+		q = bits_last(o.rows, stop, p - 1);
+		return q == -1 ? stop : q + 1;
+	case Dir::Down: {
+		int t = board_transpose[p];
+		q = bits_first(o.cols, t + 1, board_transpose[stop]);
+		return q == -1 ? stop : p + (q - t - 1) * BoardWidth;
+	}
+	default: {
+		int t = board_transpose[p];
+		q = bits_last(o.cols, board_transpose[stop], t - 1);
+		return q == -1 ? stop : p - (t - q - 1) * BoardWidth;
+	}
+	}
+}
+
+/* calls visit(q) for every position q from which an atom, sliding in the 
+ * direction opposite to d, stops at p: the free cells from p on in direction
+ * d, if p has an obstacle behind it. these are the moves of a search 
+ * backwards from a state */
+template<typename Visit>
+inline void reverse_slides(const Occupancy& o, Pos p, int d, Visit visit) {
+	const int step = PosDirections[d];
+	if (not o.is_obstacle(p - step)) return;
+	for (int q = p + step; not o.is_obstacle(q); q += step) visit(Pos(q));
+}
+
+} // namespace AtomixNamespace
@@ -35,14 +35,16 @@
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 State single_final_state;
 int single_final_state_index = 0;
 
 int calc_initial_heuristic() {
 	int initial_max_moves = numeric_limits<int>::max();
-	for (auto& f : final_states) {
+	for (int i = 0; i < NumFinalStates; ++i) {
 		initial_max_moves = min(initial_max_moves,
-			f.standard_heuristic(initial_state));
+			final_states[i].standard_heuristic(initial_state));
 	}
 
 #if ParamPDB == PDBDynamic
@@ -84,3 +86,5 @@ vector<State> one_final_state() {
 	}	
 	return{};
 }
+
+} // namespace AtomixNamespace
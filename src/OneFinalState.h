@@ -26,9 +26,13 @@
 #include "State.h"
 #include <vector>
 
+namespace AtomixNamespace {
+
 int calc_initial_heuristic();
 
 std::vector<State> one_final_state();
 
 extern State single_final_state;
-extern int single_final_state_index;
\ No newline at end of file
+extern int single_final_state_index;
+
+} // namespace AtomixNamespace
@@ -0,0 +1,158 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "Options.h"
+#include "Definitions.h"
+#include "Parameters.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <ciso646>
+#include <thread>
+
+using namespace std;
+
+string option_input_file, option_output_file, option_pdb_cache_dir;
+string option_checkpoint_file, option_resume_file;
+string option_external_dir = ".";
+int option_time_limit = 30, option_memory_limit = 500;
+bool option_silent = false, option_print_output_path = false;
+bool option_print_initial_heuristic = false, option_run_test = false;
+int option_num_random_static_pdbs = 5, option_random_seed = -1;
+int option_random_static_pdb = RandomStaticPDBGreedy, option_pdb_threads = 0;
+
+void print_usage(const char* program) {
+	cerr << "usage: " << program << " -i <input file> [options]\n"
+		"  -o <file>              output file\n"
+		"  -t <seconds>           time limit (default 30)\n"
+		"  -m <MB>                memory limit (default 500)\n"
+		"  --seed <n>             random seed; random if smaller than 0\n"
+		"  --numstatic <n>        number of random static PDBs (default 5, "
+		"at most " << MaxNumRandomStaticPDBs << ")\n"
+		"  --randomstatic <type>  'greedy' (default) or 'random'\n"
+		"  --pdbcache <dir>       store static PDBs in dir, and load them from it\n"
+		"                         in later runs\n"
+		"  --pdbthreads <n>       threads that compute the static PDBs; 0 "
+		"(default)\n"
+		"                         uses one per hardware thread\n"
+		"  --checkpoint <file>    if the search is stopped by the time or memory\n"
+		"                         limit, or fills the states table, write its\n"
+		"                         state to file\n"
+		"  --resume <file>        continue the search written by --checkpoint\n"
+		"  --extdir <dir>         directory of the run files of external A*\n"
+		"                         (default .)\n"
+		"  --silent               don't print to stdout\n"
+		"  --path                 print the solution path\n"
+		"  --initial              only print the initial heuristic value\n"
+		"  --test                 run the test hook in Solver.cpp\n";
+}
+
+bool parse_options(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		string o = argv[i];
+		bool has_value = i + 1 < argc;
+		if (o == "-h" or o == "--help") {
+			print_usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		} else if (o == "--silent") {
+			option_silent = true;
+		} else if (o == "--path") {
+			option_print_output_path = true;
+		} else if (o == "--initial") {
+			option_print_initial_heuristic = true;
+		} else if (o == "--test") {
+			option_run_test = true;
+		} else if (not has_value) {
+			cerr << "Unknown option or missing value: " << o << "\n";
+			return false;
+		} else if (o == "-i" or o == "--in") {
+			option_input_file = argv[++i];
+		} else if (o == "-o" or o == "--out") {
+			option_output_file = argv[++i];
+		} else if (o == "-t" or o == "--time") {
+			option_time_limit = atoi(argv[++i]);
+		} else if (o == "-m" or o == "--memory") {
+			option_memory_limit = atoi(argv[++i]);
+		} else if (o == "--seed") {
+			option_random_seed = atoi(argv[++i]);
+		} else if (o == "--numstatic") {
+			option_num_random_static_pdbs = atoi(argv[++i]);
+		} else if (o == "--pdbthreads") {
+			option_pdb_threads = atoi(argv[++i]);
+		} else if (o == "--pdbcache") {
+			option_pdb_cache_dir = argv[++i];
+		} else if (o == "--checkpoint") {
+			option_checkpoint_file = argv[++i];
+		} else if (o == "--resume") {
+			option_resume_file = argv[++i];
+		} else if (o == "--extdir") {
+			option_external_dir = argv[++i];
+		} else if (o == "--randomstatic") {
+			string v = argv[++i];
+			if (v == "greedy") {
+				option_random_static_pdb = RandomStaticPDBGreedy;
+			} else if (v == "random") {
+				option_random_static_pdb = RandomStaticPDBRandom;
+			} else {
+				cerr << "Unknown value for --randomstatic: " << v << "\n";
+				return false;
+			}
+		} else {
+			cerr << "Unknown option: " << o << "\n";
+			return false;
+		}
+	}
+	if (option_input_file.empty()) {
+		cerr << "No input file given.\n";
+		return false;
+	}
+	if (option_random_seed < 0) option_random_seed = -1;
+	if (option_num_random_static_pdbs < 0 or 
+		option_num_random_static_pdbs > MaxNumRandomStaticPDBs) {
+		cerr << "--numstatic must be between 0 and " 
+			<< MaxNumRandomStaticPDBs << ".\n";
+		return false;
+	}
+	bool checkpoints = not option_checkpoint_file.empty() or 
+		not option_resume_file.empty();
+#if (ParamAlgorithm != AlgAStar && ParamAlgorithm != AlgPEAStar) || \
+	ParamHeuristic != HeuAllFinalStates || ParamNumThreads > 1
+	if (checkpoints) {
+		cerr << "--checkpoint and --resume need single-threaded A* or PEA* "
+			"with the all final states heuristic.\n";
+		return false;
+	}
+#endif
+	/* a resumed search must see the same random static PDBs */
+	if (checkpoints and ParamPDB == PDBStatic and 
+		option_num_random_static_pdbs > 0 and option_random_seed < 0) {
+		cerr << "--checkpoint and --resume need --seed with random static "
+			"PDBs.\n";
+		return false;
+	}
+	if (option_pdb_threads <= 0) {
+		option_pdb_threads = MyMax(1, (int)thread::hardware_concurrency());
+	}
+	return true;
+}
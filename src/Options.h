@@ -0,0 +1,60 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include <string>
+
+/* parameters that don't change the code that is compiled are read from the 
+ * command line. see print_usage() in Options.cpp for the options */
+#define ParamInputFile (option_input_file.c_str())
+#define ParamOutputFile (option_output_file.c_str())
+#define ParamTimeLimit option_time_limit
+#define ParamMemoryLimit option_memory_limit
+#define ParamSilent option_silent
+#define ParamPrintOutputPath option_print_output_path
+#define ParamPrintInitialHeuristic option_print_initial_heuristic
+#define ParamNumRandomStaticPDBs option_num_random_static_pdbs
+#define ParamRandomSeed option_random_seed
+#define ParamRandomStaticPDB option_random_static_pdb
+#define ParamPDBThreads option_pdb_threads
+#define ParamCheckpointFile (option_checkpoint_file.c_str())
+#define ParamResumeFile (option_resume_file.c_str())
+#define ParamExternalDir (option_external_dir.c_str())
+
+/* upper bound on ParamNumRandomStaticPDBs, which sizes the static PDB arrays */
+#define MaxNumRandomStaticPDBs 16
+
+extern std::string option_input_file, option_output_file, option_pdb_cache_dir;
+extern std::string option_checkpoint_file, option_resume_file;
+extern std::string option_external_dir;
+extern int option_time_limit, option_memory_limit;
+extern bool option_silent, option_print_output_path;
+extern bool option_print_initial_heuristic, option_run_test;
+extern int option_num_random_static_pdbs, option_random_seed;
+extern int option_random_static_pdb, option_pdb_threads;
+
+void print_usage(const char* program);
+
+/* returns false, after printing the reason, if the options are not valid */
+bool parse_options(int argc, char** argv);
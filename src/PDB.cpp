@@ -27,23 +27,22 @@
 #include "StaticPDB.h"
 #include "OneFinalState.h"
 #include "Atomix.h"
+#include "AStar.h"
 #include "Print.h"
 #include <limits>
 #include <algorithm>
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 void heuristic_pdb(State& s) {
 #if ParamPDB == PDBDynamic
 	#if ParamHeuristic == HeuAllFinalStates 
-		#if NumFinalStates > 1
 	uchar pdb_heuristic = numeric_limits<uchar>::max();
 	for (int i = 0; i < NumFinalStates; ++i)
 		pdb_heuristic = min(pdb_heuristic, pdb[i].heuristic_matching(s));
 	s.h_value = max(s.std_h_value, pdb_heuristic);
-		#else // NumFinalStates == 1
-	s.h_value = max(s.std_h_value, pdb[0].heuristic_matching(s));
-		#endif 
 	#elif ParamHeuristic == HeuOneFinalState
 	s.h_value = max(s.std_h_value,
 		pdb[single_final_state_index].heuristic_matching(s));
@@ -52,14 +51,10 @@ void heuristic_pdb(State& s) {
 	s.h_value = max(s.std_h_value, pdb.heuristic_matching(s));
 #elif ParamPDB == PDBStatic
 	#if ParamHeuristic == HeuAllFinalStates 
-		#if NumFinalStates > 1
 	uchar pdb_heuristic = numeric_limits<uchar>::max();
 	for (int i = 0; i < NumFinalStates; ++i)
 		pdb_heuristic = min(pdb_heuristic, static_pdb_heuristic(s, i));
 	s.h_value = max(s.std_h_value, pdb_heuristic);
-		#else // NumFinalStates == 1
-	s.h_value = max(s.std_h_value, static_pdb_heuristic(s, 0));
-		#endif 
 	#elif ParamHeuristic == HeuOneFinalState
 	s.h_value = max(s.std_h_value, 
 		static_pdb_heuristic(s, single_final_state_index));
@@ -67,4 +62,23 @@ void heuristic_pdb(State& s) {
 #else 
 	(void)s;
 #endif
-}
\ No newline at end of file
+}
+
+void heuristic_pdb_delta(State& s) {
+#if ParamPDB == PDBStatic
+	#if ParamHeuristic == HeuAllFinalStates 
+	uchar pdb_heuristic = numeric_limits<uchar>::max();
+	for (int i = 0; i < NumFinalStates; ++i)
+		pdb_heuristic = min(pdb_heuristic, 
+			static_pdb_heuristic_delta(s, i, *cur_state, atom_moved));
+	s.h_value = max(s.std_h_value, pdb_heuristic);
+	#elif ParamHeuristic == HeuOneFinalState
+	s.h_value = max(s.std_h_value, static_pdb_heuristic_delta(s, 
+		single_final_state_index, *cur_state, atom_moved));
+	#endif 
+#else 
+	heuristic_pdb(s);
+#endif
+}
+
+} // namespace AtomixNamespace
@@ -25,7 +25,48 @@
 #pragma once
 #include "State.h"
 #include "Parameters.h"
+#include <cstddef>
+
+namespace AtomixNamespace {
 
 using PDBDataType = unsigned char;
 
-void heuristic_pdb(State& s);
\ No newline at end of file
+/* how the entries of the PDB tables are stored (ParamPDBStorage). with 
+ * PDBStorageNibble, every entry takes 4 bits and saturates at 15. with 
+ * PDBStorageMin, every two adjacent entries are merged into one that holds 
+ * their minimum. both halve the tables and keep the heuristic admissible */
+#define PDBMinCompressed (ParamPDBStorage == PDBStorageMin)
+
+/* the number of bytes of a table of n entries. packed tables hold two 
+ * entries per byte */
+inline size_t pdb_table_bytes(size_t n, bool packed) {
+	if (PDBMinCompressed) n = (n + 1) / 2;
+	return packed ? (n + 1) / 2 : n;
+}
+
+/* a table starts with all bytes set to 0xff */
+inline int pdb_get(const PDBDataType* table, size_t t, bool packed) {
+	if (PDBMinCompressed) t >>= 1;
+	return packed ? (table[t >> 1] >> ((t & 1) * 4)) & 15 : table[t];
+}
+
+/* sets entry t of the table to value, if that is smaller than it */
+inline void pdb_lower(PDBDataType* table, size_t t, int value, bool packed) {
+	if (packed) value = MyMin(value, 15);
+	if (pdb_get(table, t, packed) <= value) return;
+	if (PDBMinCompressed) t >>= 1;
+	if (packed) {
+		int shift = (t & 1) * 4;
+		table[t >> 1] = (table[t >> 1] & ~(15 << shift)) | (value << shift);
+	} else {
+		table[t] = value;
+	}
+}
+
+void heuristic_pdb(State& s);
+
+/* the same as heuristic_pdb, for a state generated from cur_state by moving 
+ * atom_moved (see AStar.h) */
+void heuristic_pdb_delta(State& s);
+
+} // namespace AtomixNamespace
@@ -0,0 +1,133 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "PDBCache.h"
+#include "Options.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <ciso646>
+#if defined(__unix__) || defined(__unix) || defined(unix) || \
+	(defined(__APPLE__) && defined(__MACH__))
+#define PDBCacheMmap true
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else 
+#define PDBCacheMmap false
+#endif
+
+using namespace std;
+
+/* bump when the layout or meaning of the stored tables changes */
+#define PDBCacheVersion 2
+
+atomic<size_t> pdb_cache_hits{0}, pdb_cache_misses{0};
+
+/* makes the names of the temporary files of concurrent stores unique */
+static atomic<unsigned> pdb_cache_tmp_count{0};
+
+struct PDBCacheHeader {
+	char magic[8];
+	uint64_t version, key, size;
+};
+
+static void make_header(PDBCacheHeader& h, uint64_t key, size_t size) {
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "atomixPD", 8);
+	h.version = PDBCacheVersion;
+	h.key = key;
+	h.size = size;
+}
+
+static string pdb_cache_path(uint64_t key) {
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.pdb", (unsigned long long)key);
+	return option_pdb_cache_dir + "/" + name;
+}
+
+#if PDBCacheMmap
+void* pdb_cache_load(uint64_t key, size_t size) {
+	if (option_pdb_cache_dir.empty()) return nullptr;
+	++pdb_cache_misses;
+	int fd = open(pdb_cache_path(key).c_str(), O_RDONLY);
+	if (fd == -1) return nullptr;
+
+	/* the table starts one page after the header, so it can be mapped 
+	 * without copying */
+	size_t offset = sysconf(_SC_PAGESIZE);
+	PDBCacheHeader h, expected;
+	make_header(expected, key, size);
+	struct stat st;
+	if (pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) or
+		memcmp(&h, &expected, sizeof(h)) != 0 or fstat(fd, &st) != 0 or
+		(size_t)st.st_size != offset + size) {
+		close(fd);
+		return nullptr;
+	}
+	void* table = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, offset);
+	close(fd);
+	if (table == MAP_FAILED) return nullptr;
+	--pdb_cache_misses;
+	++pdb_cache_hits;
+	return table;
+}
+
+void pdb_cache_store(uint64_t key, const void* table, size_t size) {
+	if (option_pdb_cache_dir.empty()) return;
+	mkdir(option_pdb_cache_dir.c_str(), 0755);
+
+	/* write to a temporary file and rename it, so that concurrent runs never
+	 * see a partial table */
+	auto path = pdb_cache_path(key);
+	auto tmp = path + "." + to_string(getpid()) + "." + 
+		to_string(pdb_cache_tmp_count++) + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if (f == nullptr) {
+		cerr << "Can't write PDB cache file " << tmp << "\n";
+		return;
+	}
+	size_t offset = sysconf(_SC_PAGESIZE);
+	PDBCacheHeader h;
+	make_header(h, key, size);
+	string header(offset, '\0');
+	memcpy(&header[0], &h, sizeof(h));
+	bool ok = fwrite(header.data(), 1, offset, f) == offset and
+		fwrite(table, 1, size, f) == size;
+	ok = fclose(f) == 0 and ok;
+	if (not ok or rename(tmp.c_str(), path.c_str()) != 0) {
+		cerr << "Can't write PDB cache file " << path << "\n";
+		remove(tmp.c_str());
+	}
+}
+#else 
+void* pdb_cache_load(uint64_t, size_t) {
+	return nullptr;
+}
+
+void pdb_cache_store(uint64_t, const void*, size_t) {
+}
+#endif
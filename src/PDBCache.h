@@ -0,0 +1,59 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+/* on-disk store of pattern database tables, so that they are computed once 
+ * per board, goal and atom group, and then memory-mapped read-only by later
+ * runs. it is enabled by --pdbcache <directory> (see Options.h) */
+
+/* 64-bit FNV-1a hash, used to build the keys of the tables */
+struct PDBCacheKey {
+	void add(const void* data, size_t size) {
+		auto p = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			h ^= p[i];
+			h *= 0x100000001b3ull;
+		}
+	}
+
+	void add(int x) { add(&x, sizeof(x)); }
+
+	uint64_t h = 0xcbf29ce484222325ull;
+};
+
+/* the functions below may be called concurrently */
+
+/* returns the table of size bytes stored under key, mapped read-only, or 
+ * nullptr if the cache is disabled or doesn't have it. the mapping lives 
+ * until the end of the program */
+void* pdb_cache_load(uint64_t key, size_t size);
+
+/* stores a table under key, if the cache is enabled */
+void pdb_cache_store(uint64_t key, const void* table, size_t size);
+
+extern std::atomic<size_t> pdb_cache_hits, pdb_cache_misses;
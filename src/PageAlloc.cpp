@@ -0,0 +1,168 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "PageAlloc.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <ciso646>
+#ifdef __linux__
+#define PageAllocMmap true
+#include <sys/mman.h>
+#else 
+#define PageAllocMmap false
+#endif
+
+using namespace std;
+
+/* the bytes held in each kind of page */
+static atomic<size_t> page_bytes_hugetlb{0}, page_bytes_advised{0}, 
+	page_bytes_small{0};
+
+#if PageAllocMmap
+/* the size of a huge page, from /proc/meminfo */
+static size_t huge_page_size() {
+	static const size_t size = [] {
+		ifstream f("/proc/meminfo");
+		string key;
+		size_t kb;
+		while (f >> key) {
+			if (key == "Hugepagesize:" and f >> kb) return kb * 1024;
+			f.ignore(256, '\n');
+		}
+		return size_t(2 << 20);
+	}();
+	return size;
+}
+
+/* the kilobytes of a line of /proc/self/smaps_rollup, or -1 */
+static long long smaps_kb(const string& name) {
+	ifstream f("/proc/self/smaps_rollup");
+	string key;
+	long long kb;
+	while (f >> key) {
+		if (key == name and f >> kb) return kb;
+		f.ignore(256, '\n');
+	}
+	return -1;
+}
+
+/* the counter of each mapping, so that page_free subtracts its bytes from 
+ * the counter that page_alloc added them to. it is never destroyed, since 
+ * the arrays of global objects are freed at exit */
+struct PageMappings {
+	mutex m;
+	unordered_map<void*, atomic<size_t>*> counter;
+};
+
+static PageMappings& page_mappings() {
+	static auto mappings = new PageMappings;
+	return *mappings;
+}
+
+static void* page_mapped(void* p, size_t len, atomic<size_t>& counter) {
+	counter += len;
+	auto& pm = page_mappings();
+	lock_guard<mutex> lock(pm.m);
+	pm.counter[p] = &counter;
+	return p;
+}
+
+#define MappedBytes(bytes) \
+	(((bytes) + huge_page_size() - 1) / huge_page_size() * huge_page_size())
+
+void* page_alloc(size_t bytes) {
+	if (bytes >= huge_page_size()) {
+		size_t len = MappedBytes(bytes);
+		void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p != MAP_FAILED) return page_mapped(p, len, page_bytes_hugetlb);
+		p = mmap(nullptr, len, PROT_READ | PROT_WRITE, 
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) throw bad_alloc();
+#ifdef MADV_HUGEPAGE
+		if (madvise(p, len, MADV_HUGEPAGE) == 0) 
+			return page_mapped(p, len, page_bytes_advised);
+#endif
+		return page_mapped(p, len, page_bytes_small);
+	}
+	void* p = malloc(bytes);
+	if (p == nullptr and bytes > 0) throw bad_alloc();
+	page_bytes_small += bytes;
+	return p;
+}
+
+void page_free(void* p, size_t bytes) {
+	if (p == nullptr) return;
+	if (bytes >= huge_page_size()) {
+		size_t len = MappedBytes(bytes);
+		auto& pm = page_mappings();
+		{
+			lock_guard<mutex> lock(pm.m);
+			auto it = pm.counter.find(p);
+			assert(it != pm.counter.end());
+			if (it == pm.counter.end()) return;
+			*it->second -= len;
+			pm.counter.erase(it);
+		}
+		munmap(p, len);
+	} else {
+		page_bytes_small -= bytes;
+		free(p);
+	}
+}
+
+void page_alloc_report(ostream& o) {
+	o << "Memory in " << huge_page_size() / 1024 << " kB huge pages: " 
+		<< (page_bytes_hugetlb >> 20) << " MB\n";
+	o << "Memory advised for transparent huge pages: " 
+		<< (page_bytes_advised >> 20) << " MB";
+	auto thp = smaps_kb("AnonHugePages:");
+	if (thp >= 0) o << " (" << (thp >> 10) << " MB in huge pages)";
+	o << "\n";
+	o << "Memory in small pages: " << (page_bytes_small >> 20) << " MB\n";
+}
+#else 
+void* page_alloc(size_t bytes) {
+	void* p = malloc(bytes);
+	if (p == nullptr and bytes > 0) throw bad_alloc();
+	page_bytes_small += bytes;
+	return p;
+}
+
+void page_free(void* p, size_t bytes) {
+	if (p != nullptr) page_bytes_small -= bytes;
+	free(p);
+}
+
+void page_alloc_report(ostream& o) {
+	o << "Memory in small pages: " << (page_bytes_small >> 20) << " MB\n";
+}
+#endif
@@ -0,0 +1,43 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <iostream>
+
+/* allocation of the large arrays of the search, the states table and the 
+ * pattern databases, which are accessed at random and so suffer from TLB 
+ * misses when backed by small pages. an array of at least one huge page is 
+ * mapped with MAP_HUGETLB if the system has huge pages reserved, and 
+ * otherwise with madvise(MADV_HUGEPAGE), which asks for transparent huge 
+ * pages. smaller arrays, and systems without mmap, use malloc. the 
+ * functions below may be called concurrently */
+
+void* page_alloc(size_t bytes);
+
+/* frees an array of page_alloc, given its size */
+void page_free(void* p, size_t bytes);
+
+/* prints how much memory is held in each kind of page */
+void page_alloc_report(std::ostream& o);
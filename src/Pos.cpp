@@ -33,7 +33,16 @@
 
 using namespace std;
 
-int PosDirections[4] = { -BoardWidth, -1, BoardWidth, 1 };
+namespace AtomixNamespace {
+
+int PosDirections[4];
+
+void pos_init() {
+	PosDirections[Dir::Up] = -BoardWidth;
+	PosDirections[Dir::Left] = -1;
+	PosDirections[Dir::Down] = BoardWidth;
+	PosDirections[Dir::Right] = 1;
+}
 
 Pos pos(int r, int c) {
 	return r * BoardWidth + c;
@@ -72,3 +81,5 @@ bool pos_valid(int x) {
 		return board[x] != '#';
 	return false;
 }
+
+} // namespace AtomixNamespace
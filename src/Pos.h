@@ -23,14 +23,20 @@
 * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #pragma once
+#include "Definitions.h"
 #include <string>
 
+namespace AtomixNamespace {
+
 using Pos = unsigned char;
 
 struct Dir {
 	enum { Up = 0, Left = 1, Down = 2, Right = 3 };
 };
 
+/* sets up PosDirections for the width of the board */
+void pos_init();
+
 Pos pos(int r, int c);
 
 int pos_r(Pos p);
@@ -49,4 +55,6 @@ std::string pos_str(int p);
 
 void pos_pretty_print(int p);
 
-extern int PosDirections[4];
\ No newline at end of file
+extern int PosDirections[4];
+
+} // namespace AtomixNamespace
@@ -41,33 +41,33 @@ std::string to_string(T val) {
 
 template<typename Head>
 void print(const Head& h) {
-#if !ParamSilent
-	std::cout << h;
-#endif
+	if (!ParamSilent) {
+		std::cout << h;
+	}
 }
 
 template<typename Head, typename... Tail>
 void print(const Head& h, Tail... tail) {
-#if !ParamSilent
-	print(h);
-	print(tail...);
-#endif
+	if (!ParamSilent) {
+		print(h);
+		print(tail...);
+	}
 }
 
 template<typename Head>
 void println(const Head& h) {
-#if !ParamSilent
-	std::cout << h << std::endl;
-#endif
+	if (!ParamSilent) {
+		std::cout << h << std::endl;
+	}
 }
 
 template<typename Head, typename... Tail>
 void println(const Head& h, Tail... tail) {
-#if !ParamSilent
-	print(h);
-	print(tail...);
-	print('\n');
-#endif
+	if (!ParamSilent) {
+		print(h);
+		print(tail...);
+		print('\n');
+	}
 }
 
 template<typename Head>
@@ -32,6 +32,28 @@
 
 using namespace std;
 
+namespace AtomixNamespace {
+
+uint64_t zobrist[NumAtoms][MaxBoardSize];
+
+void zobrist_init() {
+	/* splitmix64 with a fixed seed, so that hashes, and the owners of states
+	 * in HDA*, are the same on every run */
+	uint64_t x = 0;
+	for (int i = 0; i < NumAtoms; ++i) {
+		if (group_begin[i] != i) {
+			memcpy(zobrist[i], zobrist[group_begin[i]], sizeof(zobrist[i]));
+			continue;
+		}
+		for (int p = 0; p < MaxBoardSize; ++p) {
+			uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			zobrist[i][p] = z ^ (z >> 31);
+		}
+	}
+}
+
 bool State::contains(Pos p) const {
 	for (int i = 0; i < StateSize; ++i) {
 		if (v[i] == p) return true;
@@ -97,8 +119,8 @@ int State::multi_atom_matching(const State& d, int a) const {
 		assert(a == group_begin[a]);
 		int gsa = group_size[a];
 
-		static int m[NumAtoms][NumAtoms];
-		static int Rmate[NumAtoms], Lmate[NumAtoms];
+		static SearchThreadLocal int m[NumAtoms][NumAtoms];
+		static SearchThreadLocal int Rmate[NumAtoms], Lmate[NumAtoms];
 		for (int i = 0; i < gsa; ++i) {
 			for (int j = 0; j < gsa; ++j) {
 				m[i][j] = relaxed_distances[v[a + i]][d.v[a + j]];
@@ -108,10 +130,4 @@ int State::multi_atom_matching(const State& d, int a) const {
 	}
 }
 
-bool State::is_obstacle(Pos p) const {
-	if (board_is_wall(p)) return true;
-	for (int i = 0; i < NumAtoms; ++i) {
-		if (v[i] == p) return true;
-	}
-	return false;
-}
\ No newline at end of file
+} // namespace AtomixNamespace
@@ -32,56 +32,104 @@
 #include <cstdint>
 #include <cstring>
 
+namespace AtomixNamespace {
+
 /* an index should be able to index a state in the algorithm execution. so if
  * we choose a 32-bit signed integer (int), we are expecting to have less than
  * 2^31-1 states, at most. this should be a signed data type! 
  * */
 typedef int Index; 
 
-#define StateSize (NumAtoms)
-struct State {
-	State() {
-		std::fill(&v[0], &v[0] + NumAtoms,
-			std::numeric_limits<Pos>::max());
+/* with ParamNumThreads > 1 the search runs on several threads (see 
+ * HDAStar.h), so the globals written during a search must be per-thread */
+#if ParamNumThreads > 1
+#define SearchThreadLocal thread_local
+#else
+#define SearchThreadLocal
+#endif
+
+/* if true (ParamCompactStates), StatesTable stores each state as its 
+ * StateInfo followed by the rank of its atom positions (see CompactState.h), 
+ * and StateInfo is packed, so that the record has no padding. StateInfo is 
+ * most of the record, so the saving is small: with PEA* a record takes 21 
+ * instead of 24 bytes with 5 atoms (12%), and 22 or 23 instead of 28 with 9, 
+ * depending on the free cells (about 20%), paid for by decoding the state on 
+ * every lookup */
+#define CompactStates ParamCompactStates
+
+#if CompactStates
+#define StateInfoPacked __attribute__((packed))
+#else 
+#define StateInfoPacked
+#endif
+
+/* the search data of a state, apart from the positions of its atoms, so that
+ * StatesTable can keep the positions in a compact form (see CompactState.h) */
+struct StateInfoPacked StateInfo {
+	unsigned char f_value() const {
+		return h_value + g_value;
 	}
 
-	State(const State& s)
-		: pq_next(s.pq_next)
-		, pq_prev(s.pq_prev)
+	Index pq_next = -1, pq_prev = -1;
+
 #if SaveSolutionPath
-		, parent(s.parent)
+	Index parent = -1;
 #endif
-		, h_value(s.h_value)
-#if ParamPDB != None && \
-	(ParamHeuristic == HeuOneFinalState || NumFinalStates == 1)	
-		, std_h_value(s.std_h_value)
+
+/* h and the standard heuristic share storage unless h_value must be computed
+ * incrementally, which happens with a single final state */
+#if ParamPDB != None	
+	unsigned char h_value = 0;
+	unsigned char std_h_value = 0;	
+#else
+	union {
+		unsigned char h_value = 0;
+		unsigned char std_h_value;		
+	};
+#endif 
+
+	unsigned char g_value = 0;		
+
+#if ParamTieBreaking == TBFillOrder || ParamTieBreaking == TBFillOrderReverse || \
+ParamTieBreaking == TBGoalCountH || ParamTieBreaking == TBHGoalCount	
+	unsigned short tie_breaker = 0;
+#else 
+	unsigned char tie_breaker = 0;
 #endif 
-		, g_value(s.g_value)					
-		, tie_breaker(s.tie_breaker) 
+
 #if ParamAlgorithm == AlgPEAStar
-		, pea_F(s.pea_F)
-#endif
-	{ 
+	unsigned char pea_F = 0;
+#endif 
+};
+
+#define StateSize (NumAtoms)
+
+/* the hash of a state is the xor of a random key for each atom and its 
+ * position (zobrist hashing). the atoms of an identical-atom group share 
+ * their keys, so the hash doesn't depend on the order of the group, and a
+ * move changes it by two keys (see hash_move). set by zobrist_init() */
+extern uint64_t zobrist[NumAtoms][MaxBoardSize];
+
+void zobrist_init();
+
+/* the hash of a state with hash h, after atom a moves from p to q */
+inline size_t hash_move(size_t h, int a, Pos p, Pos q) {
+	return h ^ zobrist[a][p] ^ zobrist[a][q];
+}
+
+struct State : StateInfo {
+	State() {
+		std::fill(&v[0], &v[0] + NumAtoms,
+			std::numeric_limits<Pos>::max());
+	}
+
+	State(const State& s) : StateInfo(s) { 
 		memcpy(&v[0], &s.v[0], NumAtoms * sizeof(Pos));
 	}
 
 	State& operator=(const State& s) {
 		memcpy(&v[0], &s.v[0], NumAtoms * sizeof(Pos));
-		h_value = s.h_value;
-		g_value = s.g_value;
-		pq_next = s.pq_next;
-		pq_prev = s.pq_prev;
-		tie_breaker = s.tie_breaker;
-#if SaveSolutionPath
-		parent = s.parent;
-#endif
-#if ParamAlgorithm == AlgPEAStar
-		pea_F = s.pea_F;
-#endif
-#if ParamPDB != None && \
-	(ParamHeuristic == HeuOneFinalState || NumFinalStates == 1)	
-		std_h_value = s.std_h_value;
-#endif 
+		StateInfo::operator=(s);
 		return *this;
 	}
 
@@ -94,8 +142,6 @@ struct State {
 			&v[0], &v[0] + NumAtoms, &s.v[0], &s.v[0] + NumAtoms);
 	}
 
-	bool is_obstacle(Pos p) const;
-
 	void pretty_print(std::ostream& o = std::cout) const;
 
 	int standard_heuristic(const State& dst) const;
@@ -108,52 +154,12 @@ struct State {
 
 	size_t get_hash() const {
 		size_t h = 0;
-		for (int i = 0; i < StateSize; ++i) {
-			h += v[i];
-			h += (h << 10);
-			h ^= (h >> 6);
-		}
-
-		h += (h << 3);
-		h ^= (h >> 11);
-		h += (h << 15);
+		for (int i = 0; i < NumAtoms; ++i)
+			h ^= zobrist[i][v[i]];
 		return h;
 	}
 
-	unsigned char f_value() const {
-		return h_value + g_value;
-	}
-
 	Pos v[NumAtoms];
-
-	Index pq_next = -1, pq_prev = -1;
-
-#if SaveSolutionPath
-	Index parent = -1;
-#endif
-
-#if ParamPDB != None && \
-	(ParamHeuristic == HeuOneFinalState || NumFinalStates == 1)	
-	unsigned char h_value = 0;
-	unsigned char std_h_value = 0;	
-#else
-	union {
-		unsigned char h_value = 0;
-		unsigned char std_h_value;		
-	};
-#endif 
-
-	unsigned char g_value = 0;		
-
-#if ParamTieBreaking == TBFillOrder || ParamTieBreaking == TBFillOrderReverse || \
-ParamTieBreaking == TBGoalCountH || ParamTieBreaking == TBHGoalCount	
-	unsigned short tie_breaker = 0;
-#else 
-	unsigned char tie_breaker = 0;
-#endif 
-
-#if ParamAlgorithm == AlgPEAStar
-	unsigned char pea_F = 0;
-#endif 
 };
 
+} // namespace AtomixNamespace
@@ -0,0 +1,85 @@
+/*
+* Solving Atomix with pattern databases
+* Copyright (c) 2016 Alex Gliesch, Marcus Ritt
+*
+* Permission is hereby granted, free of charge, to any person (the "Person")
+* obtaining a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software, including the rights to use, copy, modify,
+* merge, publish, distribute the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+* 2. Under no circumstances shall the Person be permitted, allowed or authorized
+*    to commercially exploit the Software.
+* 3. Changes made to the original Software shall be labeled, demarcated or
+*    otherwise identified and attributed to the Person.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+* FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+* COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+* IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+* CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+#include "State.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace AtomixNamespace {
+
+/* a set of search nodes, each with the positions v of its state, indexed by 
+ * open addressing on their zobrist hash. used by the searches that keep their
+ * states apart from StatesTable */
+template<typename Node>
+struct StateSet {
+	/* the index of the node of the state with positions v, or -1 */
+	int find(const Pos* v) const {
+		if (nodes.empty()) return -1;
+		for (size_t h = hash(v) & (slots.size() - 1);; 
+			h = (h + 1) & (slots.size() - 1)) {
+			int i = slots[h];
+			if (i == -1 or memcmp(nodes[i].v, v, sizeof(nodes[i].v)) == 0) 
+				return i;
+		}
+	}
+
+	/* the index of the new node, or -1 if its state was already in the set */
+	int insert(const Node& n) {
+		if (2 * (nodes.size() + 1) > slots.size()) grow();
+		size_t h = hash(n.v) & (slots.size() - 1);
+		for (; slots[h] != -1; h = (h + 1) & (slots.size() - 1))
+			if (memcmp(nodes[slots[h]].v, n.v, sizeof(n.v)) == 0) return -1;
+		slots[h] = nodes.size();
+		nodes.push_back(n);
+		return slots[h];
+	}
+
+	void clear() {
+		nodes.clear();
+		slots.assign(16, -1);
+	}
+
+	std::vector<Node> nodes;
+	std::vector<int> slots;
+
+private:
+	static size_t hash(const Pos* v) {
+		size_t h = 0;
+		for (int i = 0; i < NumAtoms; ++i) h ^= zobrist[i][v[i]];
+		return h;
+	}
+
+	void grow() {
+		slots.assign(std::max<size_t>(16, 2 * slots.size()), -1);
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			size_t h = hash(nodes[i].v) & (slots.size() - 1);
+			while (slots[h] != -1) h = (h + 1) & (slots.size() - 1);
+			slots[h] = i;
+		}
+	}
+};
+
+} // namespace AtomixNamespace
@@ -32,39 +32,52 @@
 #include <algorithm>
 #include <cassert>
 #include <ciso646>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 StatesTable states_table;
 
 void StatesTable::reset(size_t num_states) {
 	this->num_states = num_states;
-	if (hash_table == nullptr) {
-		hash_table = new Index[HashTableSize];
-	}
-	memset(hash_table, -1, sizeof(Index) * HashTableSize);
-	hash_occupation = 0;
+	/* the largest power of two up to num_states * HashLoadFactor, which 
+	 * keeps the load of the table below 1 / (HashLoadFactor / 2) */
+	max_hash_table_size = HashGroupSize;
+	while (max_hash_table_size * 2 <= size_t(num_states * HashLoadFactor))
+		max_hash_table_size *= 2;
+
+	/* the index starts small again, while the allocated state chunks are 
+	 * kept for reuse */
+	hash_free();
+	hash_table_size = min(HashInitialSize, max_hash_table_size);
+	hash_alloc();
 
-	if (states == nullptr) {
-		states = new State[num_states];
-	}
-#if ParamAlgorithm == AlgPEAStar
-	states_top = 1 + MaxNeighbours;
-#else
 	states_top = 1;
-#endif
 	smallest_pq_index = numeric_limits<int>::max();
 
 	if (pq == nullptr) {
-		pq = new Index[PqSize];		
+		pq = static_cast<Index*>(page_alloc(PqSize * sizeof(Index)));
+		pq_bits = new uint64_t[PqBitsWords];
+		pq_summary = new uint64_t[PqSummaryWords];
 	}
 	memset(pq, -1, PqSize * sizeof(Index));
+	memset(pq_bits, 0, PqBitsWords * sizeof(uint64_t));
+	memset(pq_summary, 0, PqSummaryWords * sizeof(uint64_t));
 }
 
-Index StatesTable::insert(const State& s) {
+Index StatesTable::insert(const State& s, size_t h) {
 	auto i = states_insert();
-	states[i] = s;
-	hash_insert(i);
+#if CompactStates
+	info(i) = s;
+	CompactState(s).store(compact_state(i));
+#else 
+	state(i) = s;
+#endif
+	hash_insert(i, h);
 #ifdef StoreNodesGeneratedStats
 	++stat_nodes_generated_with_f_value[s.f_value()];
 	++stat_nodes_generated_with_g_value[s.g_value];
@@ -74,29 +87,48 @@ Index StatesTable::insert(const State& s) {
 }
 
 Index StatesTable::states_insert() {
-	++states_top;
-	if (states_top == MaxStates) {
+	/* the table is left as it was, so that it can still be checkpointed */
+	if (states_top + 1 == num_states) {
 		throw TerminationException("Maximum number of states reached.");
 	}
+	++states_top;
+	Index i = states_top - 1;
+	states_reserve(states_top);
 	++stat_nodes_generated;
-	return states_top - 1;
+	return i;
+}
+
+void StatesTable::states_reserve(size_t n) {
+	/* the chunks are left unconstructed, since a state is always assigned 
+	 * before it is read, so that their pages are only touched as states are
+	 * inserted */
+#if CompactStates
+	while (record_chunks.size() * StateChunkSize < n)
+		record_chunks.push_back(static_cast<unsigned char*>(
+			page_alloc(StateChunkSize * SizeState)));
+#else 
+	while (state_chunks.size() * StateChunkSize < n)
+		state_chunks.push_back(static_cast<State*>(
+			page_alloc(StateChunkSize * sizeof(State))));
+#endif
 }
 
 void StatesTable::pq_push(Index s) {	
 	auto i = pq_index(s);
 	/* note that this is fifo order: the newly inserted item is placed in
 	* front of the queue */	
-	states[s].pq_next = pq[i];
-	states[s].pq_prev = -1;
-	if (states[s].pq_next != -1) {
-		states[states[s].pq_next].pq_prev = s;
+	info(s).pq_next = pq[i];
+	info(s).pq_prev = -1;
+	if (info(s).pq_next != -1) {
+		info(info(s).pq_next).pq_prev = s;
 	}
 	pq[i] = s;
+	pq_mark(i);
 	smallest_pq_index = min(smallest_pq_index, i);
 }
 
 void StatesTable::pq_update(Index s, int g) {	
-	auto& S = states[s];
+	auto& S = info(s);
 	auto old_pq_index = pq_index(s);
 	S.g_value = g;
 	auto new_pq_index = pq_index(s);
@@ -107,96 +139,282 @@ void StatesTable::pq_update(Index s, int g) {
 
 	if (pq[old_pq_index] == s) { 
 		// if s is top of pq
-		assert(states[s].pq_prev == -1);
-		pq[old_pq_index] = states[s].pq_next;
+		assert(S.pq_prev == -1);
+		pq[old_pq_index] = S.pq_next;
 		if (pq[old_pq_index] != -1) {
-			states[pq[old_pq_index]].pq_prev = -1;
+			info(pq[old_pq_index]).pq_prev = -1;
 		}
+		pq_unmark_if_empty(old_pq_index);
 	} else {
 		// is is not on top of pq
-		if (states[s].pq_prev == -1) {
+		if (S.pq_prev == -1) {
 			++stat_num_reopened_states;
 		} else {
-			states[states[s].pq_prev].pq_next = states[s].pq_next;
+			info(S.pq_prev).pq_next = S.pq_next;
 		}
-		if (states[s].pq_next != -1) {
-			states[states[s].pq_next].pq_prev = states[s].pq_prev;
+		if (S.pq_next != -1) {
+			info(S.pq_next).pq_prev = S.pq_prev;
 		}
 	}
 
-	states[s].pq_next = pq[new_pq_index];
-	states[s].pq_prev = -1;
-	if (states[s].pq_next != -1) {
-		states[states[s].pq_next].pq_prev = s;
+	S.pq_next = pq[new_pq_index];
+	S.pq_prev = -1;
+	if (S.pq_next != -1) {
+		info(S.pq_next).pq_prev = s;
 	}
 	pq[new_pq_index] = s;
+	pq_mark(new_pq_index);
 	smallest_pq_index = min(smallest_pq_index, new_pq_index);
 }
 
 Index StatesTable::pq_pop() {
-	while (smallest_pq_index < PqSize) {				
-		if (pq[smallest_pq_index] != -1) {			
-			auto s = pq[smallest_pq_index];			
-			pq[smallest_pq_index] = states[s].pq_next;
-			if (states[s].pq_next != -1) {
-				states[states[s].pq_next].pq_prev = -1;
-			}
-			states[s].pq_next = -1;			
-			assert(states[s].pq_prev == -1);
-			++stat_nodes_expanded;
-			if (smallest_pq_index != pq_index(s)) {
-				continue;
-			}						
-			return s;
+	while ((smallest_pq_index = pq_next_bucket(smallest_pq_index)) < PqSize) {
+		auto s = pq[smallest_pq_index];			
+		pq[smallest_pq_index] = info(s).pq_next;
+		if (info(s).pq_next != -1) {
+			info(info(s).pq_next).pq_prev = -1;
 		}
-		++smallest_pq_index;
+		pq_unmark_if_empty(smallest_pq_index);
+		info(s).pq_next = -1;			
+		assert(info(s).pq_prev == -1);
+		++stat_nodes_expanded;
+		if (smallest_pq_index != pq_index(s)) {
+			continue;
+		}						
+		return s;
 	}
 	return -1;
 }
 
+int StatesTable::pq_min_f() {
+	smallest_pq_index = pq_next_bucket(smallest_pq_index);
+	if (smallest_pq_index >= PqSize) return -1;
+#if ParamTieBreaking == None
+	return smallest_pq_index;
+#else 
+	return smallest_pq_index / (MaxTieBreakingValue + 1);
+#endif
+}
+
 Index StatesTable::pq_index(Index s) {
-	assert(states[s].tie_breaker <= MaxTieBreakingValue);
+	assert(info(s).tie_breaker <= MaxTieBreakingValue);
 #if ParamTieBreaking == None
-	return states[s].f_value();
+	return info(s).f_value();
 #else 
-	return states[s].f_value() * (MaxTieBreakingValue + 1)
-		+ MaxTieBreakingValue - states[s].tie_breaker;
+	return info(s).f_value() * (MaxTieBreakingValue + 1)
+		+ MaxTieBreakingValue - info(s).tie_breaker;
 #endif
 }
 
+void StatesTable::pq_mark(int i) {
+	pq_bits[i >> 6] |= uint64_t(1) << (i & 63);
+	pq_summary[i >> 12] |= uint64_t(1) << ((i >> 6) & 63);
+}
+
+void StatesTable::pq_unmark_if_empty(int i) {
+	if (pq[i] != -1) return;
+	pq_bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+	if (pq_bits[i >> 6] == 0)
+		pq_summary[i >> 12] &= ~(uint64_t(1) << ((i >> 6) & 63));
+}
+
+int StatesTable::pq_next_bucket(int i) {
+	if (i >= PqSize) return PqSize;
+	int w = i >> 6;
+	uint64_t x = pq_bits[w] & (~uint64_t(0) << (i & 63));
+	if (x) return w * 64 + __builtin_ctzll(x);
+	/* the next non-zero word of pq_bits, from the summary */
+	for (int j = w + 1; j < PqBitsWords; j = (j | 63) + 1) {
+		uint64_t y = pq_summary[j >> 6] & (~uint64_t(0) << (j & 63));
+		if (y) {
+			int k = (j & ~63) + __builtin_ctzll(y);
+			return k * 64 + __builtin_ctzll(pq_bits[k]);
+		}
+	}
+	return PqSize;
+}
+
+#define WriteItems(f, p, n) (fwrite((p), sizeof(*(p)), (n), (f)) == size_t(n))
+#define ReadItems(f, p, n) (fread((p), sizeof(*(p)), (n), (f)) == size_t(n))
+
+/* the states are stored chunk by chunk, up to states_top, followed by the 
+ * hash index and the queue as they are in memory, since the indexes of the 
+ * states don't change */
+bool StatesTable::save(FILE* f) {
+	bool ok = WriteItems(f, &states_top, 1) and 
+		WriteItems(f, &smallest_pq_index, 1) and 
+		WriteItems(f, &hash_table_size, 1) and 
+		WriteItems(f, &hash_occupation, 1);
+	for (size_t i = 0; ok and i < states_top; i += StateChunkSize) {
+		size_t n = min(StateChunkSize, states_top - i);
+#if CompactStates
+		ok = WriteItems(f, record_chunks[i >> StateChunkBits], n * SizeState);
+#else 
+		ok = WriteItems(f, state_chunks[i >> StateChunkBits], n);
+#endif
+	}
+	return ok and WriteItems(f, hash_tags, hash_table_size + HashGroupSize) and
+		WriteItems(f, hash_table, hash_table_size) and 
+		WriteItems(f, pq, PqSize);
+}
+
+bool StatesTable::load(FILE* f) {
+	size_t top, hts, occupation;
+	int smallest;
+	if (not (ReadItems(f, &top, 1) and ReadItems(f, &smallest, 1) and 
+		ReadItems(f, &hts, 1) and ReadItems(f, &occupation, 1)))
+		return false;
+	if (top >= num_states or hts > max_hash_table_size or 
+		(hts & (hts - 1)) != 0 or hts < HashGroupSize)
+		return false;
+	states_top = top;
+	smallest_pq_index = smallest;
+	states_reserve(states_top);
+	bool ok = true;
+	for (size_t i = 0; ok and i < states_top; i += StateChunkSize) {
+		size_t n = min(StateChunkSize, states_top - i);
+#if CompactStates
+		ok = ReadItems(f, record_chunks[i >> StateChunkBits], n * SizeState);
+#else 
+		ok = ReadItems(f, state_chunks[i >> StateChunkBits], n);
+#endif
+	}
+	hash_free();
+	hash_table_size = hts;
+	hash_alloc();
+	hash_occupation = occupation;
+	ok = ok and ReadItems(f, hash_tags, hash_table_size + HashGroupSize) and
+		ReadItems(f, hash_table, hash_table_size) and ReadItems(f, pq, PqSize);
+	for (int i = 0; i < PqSize; ++i)
+		if (pq[i] != -1) pq_mark(i);
+	return ok;
+}
+
 bool StatesTable::state_already_expanded(Index i) {
-	return states[i].pq_prev == -1 and states[i].pq_next == -1 and
+	return info(i).pq_prev == -1 and info(i).pq_next == -1 and
 		pq[pq_index(i)] != i;
 }
 
-void StatesTable::hash_insert(Index i) {
-	size_t h = states[i].get_hash() % HashTableSize;
-	while (hash_table[h] != -1) {
-		if (states[hash_table[h]] == states[i]) {
+#if CompactStates
+#define SameState(i, j) \
+	(memcmp(compact_state(i), compact_state(j), compact_state_bytes) == 0)
+#define IsState(i, key) key.equals(compact_state(i))
+#else 
+#define SameState(i, j) (state(i) == state(j))
+#define IsState(i, key) (state(i) == key)
+#endif
+
+/* the fingerprint of a hash, taken from its high bits, since the slot is 
+ * given by its low bits */
+static inline unsigned char hash_tag(size_t h) {
+	return (unsigned char)(uint64_t(h) >> 57) | 0x80;
+}
+
+/* sets bit k of match if tag k of the group starting at t equals tag, and 
+ * bit k of empty if it is an empty slot */
+static inline void hash_group(const unsigned char* t, unsigned char tag, 
+	unsigned& match, unsigned& empty) {
+#ifdef __SSE2__
+	__m128i g = _mm_loadu_si128((const __m128i*)t);
+	match = _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+	empty = _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_setzero_si128()));
+#else 
+	match = empty = 0;
+	for (int k = 0; k < HashGroupSize; ++k) {
+		match |= unsigned(t[k] == tag) << k;
+		empty |= unsigned(t[k] == 0) << k;
+	}
+#endif
+}
+
+void StatesTable::hash_alloc() {
+	hash_table = static_cast<Index*>(
+		page_alloc(hash_table_size * sizeof(Index)));
+	hash_tags = static_cast<unsigned char*>(
+		page_alloc(hash_table_size + HashGroupSize));
+	/* the empty slots are given by the tags, so hash_table needs no reset */
+	memset(hash_tags, 0, hash_table_size + HashGroupSize);
+	hash_occupation = 0;
+}
+
+void StatesTable::hash_free() {
+	page_free(hash_table, hash_table_size * sizeof(Index));
+	page_free(hash_tags, hash_table_size + HashGroupSize);
+	hash_table = nullptr;
+	hash_tags = nullptr;
+}
+
+void StatesTable::hash_grow() {
+	auto old_table = hash_table;
+	auto old_tags = hash_tags;
+	size_t old_size = hash_table_size;
+	hash_table_size *= 2;
+	hash_alloc();
+	for (size_t j = 0; j < old_size; ++j)
+		if (old_tags[j] != 0)
+			hash_insert(old_table[j], get_state(old_table[j]).get_hash());
+	page_free(old_table, old_size * sizeof(Index));
+	page_free(old_tags, old_size + HashGroupSize);
+}
+
+void StatesTable::hash_insert(Index i, size_t hv) {
+	if (hash_occupation + 1 > hash_table_size * HashGrowLoad and 
+		hash_table_size < max_hash_table_size)
+		hash_grow();
+	const size_t hts = hash_table_size, mask = hts - 1;
+	size_t h = hv & mask;
+	unsigned char tag = hash_tag(hv);
+	while (true) {
+		unsigned match, empty;
+		hash_group(hash_tags + h, tag, match, empty);
+		if (empty) match &= (empty & -empty) - 1;
+		for (; match; match &= match - 1) {
+			size_t slot = (h + __builtin_ctz(match)) & mask;
+			if (SameState(hash_table[slot], i)) {
+				return;
+			}
+		}
+		if (empty) {
+			size_t slot = (h + __builtin_ctz(empty)) & mask;
+			hash_table[slot] = i;
+			hash_tags[slot] = tag;
+			if (slot < HashGroupSize) hash_tags[hts + slot] = tag;
+			++hash_occupation;
 			return;
 		}
-		h = (h + 1) % HashTableSize;
+		h = (h + HashGroupSize) & mask;
 	}
-	hash_table[h] = i;
-	++hash_occupation;
 }
 
-Index StatesTable::hash_find(Index i) {
+Index StatesTable::hash_find(const State& s, size_t hv) {
 #if StatCountAvgHashProbes
 	++stat_hash_find_calls;
-	++stat_hash_probes;
 #endif 
-	static const size_t hts = HashTableSize;
-	size_t h = states[i].get_hash() % hts;
-	while (hash_table[h] != -1) {
-		if (states[hash_table[h]] == states[i]) {
-			return hash_table[h];
-		}
-		if (++h >= hts) h = 0;
-		//h = (h + 1) % hts;
+#if CompactStates
+	CompactState key(s);
+#else 
+	auto& key = s;
+#endif
+	const size_t mask = hash_table_size - 1;
+	size_t h = hv & mask;
+	unsigned char tag = hash_tag(hv);
+	while (true) {
+		unsigned match, empty;
+		hash_group(hash_tags + h, tag, match, empty);
+		/* the state can only be before the first empty slot */
+		if (empty) match &= (empty & -empty) - 1;
+		for (; match; match &= match - 1) {
+			size_t slot = (h + __builtin_ctz(match)) & mask;
 #if StatCountAvgHashProbes
-		++stat_hash_probes;
+			++stat_hash_probes;
 #endif
+			if (IsState(hash_table[slot], key)) {
+				return hash_table[slot];
+			}
+		}
+		if (empty) return -1;
+		h = (h + HashGroupSize) & mask;
 	}
-	return -1;
 }
+
+} // namespace AtomixNamespace
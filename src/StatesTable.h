@@ -27,23 +27,63 @@
 #include "Parameters.h"
 #include "TieBreaking.h"
 #include "StaticPDB.h"
+#include "DynamicPDB.h"
+#include "CompactState.h"
+#include "PageAlloc.h"
+#include <cstdio>
 #include <vector>
 
+namespace AtomixNamespace {
+
 #define HashLoadFactor 2.5
+#define HashGroupSize 16
 #define MemoryLimitBytes (size_t(ParamMemoryLimit * 1024LL * 1024LL))
 #if ParamPDB == PDBStatic
 	#define MemoryForStates (MemoryLimitBytes - StaticPDBSizeBytes)
+#elif ParamPDB == PDBDynamic
+	#define MemoryForStates (MemoryLimitBytes - \
+		NumFinalStates * DynamicPDBSizeBytes)
+#elif ParamPDB == PDBMultiGoal
+	#define MemoryForStates (MemoryLimitBytes - DynamicPDBSizeBytes)
 #else 
 	#define MemoryForStates MemoryLimitBytes
 #endif
-#define SizeState (sizeof(State))
+#if CompactStates
+	#define SizeState (sizeof(StateInfo) + compact_state_bytes)
+#else 
+	#define SizeState (sizeof(State))
+#endif
 #define MaxStates (size_t(MemoryForStates \
-	/ (SizeState + sizeof(Index) * HashLoadFactor)))
-#define HashTableSize (size_t(MaxStates * HashLoadFactor))
+	/ (SizeState + (sizeof(Index) + 1) * HashLoadFactor)))
+
+/* MaxStates is only an upper bound: the states are stored in chunks of 
+ * StateChunkSize, which are allocated when the search reaches them, and the 
+ * hash index starts with HashInitialSize slots and doubles whenever its load
+ * passes HashGrowLoad, until it reaches the largest power of two up to 
+ * MaxStates * HashLoadFactor. all of them come from page_alloc, and a chunk
+ * of uncompacted states is a multiple of 2 MB, since states are a multiple of
+ * 4 bytes, so that it fills whole huge pages */
+#define StateChunkBits 19
+#define StateChunkSize (size_t(1) << StateChunkBits)
+#define HashInitialSize (size_t(1) << 16)
+#define HashGrowLoad 0.5
 
 #define PqSize (GuessOnMaximumFValue*MaxTieBreakingValue) 
+#define PqBitsWords ((PqSize + 63) / 64)
+#define PqSummaryWords ((PqBitsWords + 63) / 64)
 
 struct StatesTable {
+	~StatesTable() {
+		page_free(pq, PqSize * sizeof(Index));
+		delete[] pq_bits;
+		delete[] pq_summary;
+		hash_free();
+#if CompactStates
+		for (auto c : record_chunks) page_free(c, StateChunkSize * SizeState);
+#else 
+		for (auto c : state_chunks) page_free(c, StateChunkSize * sizeof(State));
+#endif
+	}
 
 	void reset(size_t num_states = MaxStates);
 
@@ -54,33 +94,121 @@ struct StatesTable {
 
 	Index pq_pop();
 
+	/* f-value of the best state in the queue, or -1 if it is empty */
+	int pq_min_f();
+
 	int pq_index(Index s);
 
-	Index hash_find(Index i);
+	/* the versions that take h use it as the hash of s, which the search can
+	 * compute incrementally (see hash_move) */
+	Index hash_find(const State& s) { return hash_find(s, s.get_hash()); }
+
+	Index hash_find(const State& s, size_t h);
+
+#if CompactStates
+	/* the record of a state: its StateInfo, followed by its rank */
+	unsigned char* record(Index i) {
+		return record_chunks[i >> StateChunkBits] + 
+			(i & (StateChunkSize - 1)) * SizeState;
+	}
 
-	State& operator()(Index i) { return states[i]; }
+	unsigned char* compact_state(Index i) { 
+		return record(i) + sizeof(StateInfo); 
+	}
 
-	Index insert(const State& s);
+	StateInfo& info(Index i) { return *reinterpret_cast<StateInfo*>(record(i)); }
+
+	State get_state(Index i) {
+		State s;
+		CompactState(compact_state(i)).decode(s);
+		static_cast<StateInfo&>(s) = info(i);
+		return s;
+	}
+#else 
+	State& state(Index i) {
+		return state_chunks[i >> StateChunkBits][i & (StateChunkSize - 1)];
+	}
+
+	StateInfo& info(Index i) { return state(i); }
+
+	State get_state(Index i) { return state(i); }
+#endif
+
+	Index insert(const State& s) { return insert(s, s.get_hash()); }
+
+	Index insert(const State& s, size_t h);
 
 	Index states_insert();
 
-	void hash_insert(Index i);
+	/* allocates the state chunks that hold the states below n */
+	void states_reserve(size_t n);
+
+	void hash_insert(Index i, size_t h);
+
+	/* doubles the hash index, and reinserts every state in it */
+	void hash_grow();
+
+	/* allocates an empty hash index of hash_table_size slots */
+	void hash_alloc();
+
+	void hash_free();
 
 	bool state_already_expanded(Index i);
 
-	Index* pq;
+	/* write the states, the hash index and the queue to f, or read them back
+	 * into a table reset with the same num_states. false if f can't be 
+	 * written or read, or if its states don't fit in num_states */
+	bool save(FILE* f);
+
+	bool load(FILE* f);
+
+	/* the first non-empty bucket of the queue at or after i, or PqSize */
+	int pq_next_bucket(int i);
+
+	void pq_mark(int i);
+
+	void pq_unmark_if_empty(int i);
+
+	Index* pq = nullptr;
+
+	/* bit i of pq_bits is set if bucket i of pq is non-empty, and bit j of 
+	 * pq_summary if word j of pq_bits is non-zero, so that the next 
+	 * non-empty bucket is found with a few bit scans however many empty 
+	 * buckets the tie breaking leaves between them */
+	uint64_t* pq_bits = nullptr;
+
+	uint64_t* pq_summary = nullptr;
 
 	int smallest_pq_index = 0;
 
 	Index* hash_table = nullptr;
 
+	/* hash_tags[h] is 0 if slot h of hash_table is empty, and otherwise a 
+	 * 7-bit fingerprint of the hash of its state, with the high bit set. the
+	 * slots are probed linearly in groups of HashGroupSize tags, and a state 
+	 * is only compared on a fingerprint match, so that most probes don't 
+	 * touch the states array. the first HashGroupSize tags are repeated after
+	 * the end of the table, so that a group never wraps around */
+	unsigned char* hash_tags = nullptr;
+
 	size_t hash_occupation = 0;
 
-	State* states = nullptr;
+	/* a power of two, so that a hash is reduced to a slot by masking */
+	size_t hash_table_size = 0;
+
+	size_t max_hash_table_size = 0;
+
+#if CompactStates
+	std::vector<unsigned char*> record_chunks;
+#else 
+	std::vector<State*> state_chunks;
+#endif
 
 	size_t states_top = 0;
 
 	size_t num_states = 0;
 };
 
-extern StatesTable states_table;
\ No newline at end of file
+extern StatesTable states_table;
+
+} // namespace AtomixNamespace
@@ -28,55 +28,108 @@
 #include "RandomNumberGenerator.h"
 #include "Statistics.h"
 #include "Definitions.h"
+#include "PDBCache.h"
+#include "StatesTable.h"
+#include "Board.h"
+#include "Timer.h"
 #include <cmath>
 #include <limits>
-#include <queue>
-#include <tuple>
 #include <ciso646>
 #include <cassert>
 #include <cstring>
 #include <vector>
 #include <set>
-#define GetPDB3(i, a, b, c) (pdb3[(i)*BoardSize*BoardSize*BoardSize + \
-	(a)*BoardSize*BoardSize + (b)*BoardSize + (c)])
-#define GetPDB2(a, b) (pdb2[(a)*BoardSize + (b)])
-#define GetPDB1(a) (pdb1[(a)])
+#include <atomic>
+#include <mutex>
+#include <thread>
+/* the tables are indexed by the free cell indexes of the positions */
+#define FreeIndex(p) (board_free_index[p])
+#define GetEntry(table, t, m) pdb_get(table, t, PDBPacked(m))
  
 using namespace std;
 
+namespace AtomixNamespace {
+
 #if ParamPDB == PDBStatic
-StaticPDB pdb[NumFinalStates];
-StaticPDB random_pdb[NumFinalStates][MyMax(1, NumRandomStaticPDBs)];
-int random_pdb_usage[1 + MyMax(1, NumRandomStaticPDBs)];
+/* the PDBs of each final state. without random PDBs, the single PDB built
+ * for it is random_pdb[f][0] */
+StaticPDB random_pdb[MaxFinalStates][MyMax(1, MaxNumRandomStaticPDBs)];
+SearchThreadLocal int random_pdb_usage[1 + MyMax(1, MaxNumRandomStaticPDBs)];
 
 void init_static_pbds() {
 	memset(random_pdb_usage, 0, sizeof(random_pdb_usage));
-#if NumRandomStaticPDBs == 0
-	create_random_static_pdbs_greedy(1);	
-	for (int f = 0; f < NumFinalStates; ++f) {
-		memcpy(&pdb[f], &random_pdb[f][0], sizeof(StaticPDB));
+#if GroupSize > 3
+	if (SingleStaticPDBSizeBytes + static_pdb_bfs_bytes(GroupSize) > 
+		MaxMemoryForStaticPDBsMB * 1000000LL) {
+		println("Static PDBs with groups of ", GroupSize, " atoms need ",
+			(SingleStaticPDBSizeBytes + static_pdb_bfs_bytes(GroupSize) + 
+			999999) / 1000000, " MB, but only ", 
+			MaxMemoryForStaticPDBsMB, " MB are available. Use a smaller "
+			"group size.");
+		exit(-1);
+	}
+#endif
+	if (NumRandomStaticPDBs == 0) {
+		create_random_static_pdbs_greedy(1);	
+	} else if (ParamRandomStaticPDB == RandomStaticPDBGreedy) {
+		create_random_static_pdbs_greedy();
+	} else if (ParamRandomStaticPDB == RandomStaticPDBRandom) {
+		create_random_static_pdbs_random();
+	}
+	if (not option_pdb_cache_dir.empty()) {
+		println("PDB cache: ", pdb_cache_hits.load(), " tables loaded, ", 
+			pdb_cache_misses.load(), " computed");
 	}
-#else 
-#if ParamRandomStaticPDB == RandomStaticPDBGreedy
-	create_random_static_pdbs_greedy();
-#elif ParamRandomStaticPDB == RandomStaticPDBRandom
-	create_random_static_pdbs_random();
-#endif 	
-#endif	
+}
+
+/* computes the tables of all groups of the given PDBs, each paired with its
+ * final state, with ParamPDBThreads threads. the groups are independent, so
+ * every thread takes the next group that is left until none is. each thread
+ * holds the bitmaps of one BFS, so there are only as many threads as there 
+ * are bitmaps that fit in the memory left by the tables */
+static void calculate_static_pdbs(
+	const vector<pair<StaticPDB*, const State*>>& pdbs) {
+	const int num_tasks = pdbs.size() * NumGroups;
+	if (num_tasks == 0) return;
+	const long long bfs_bytes = static_pdb_bfs_bytes(GroupSize);
+	const int num_threads = MyMax(1, MyMin(MyMin(ParamPDBThreads, num_tasks),
+		(long long)MemoryForStates / bfs_bytes));
+	println("Computing ", num_tasks, " PDB tables with ", num_threads, 
+		" threads");
+
+	Timer<> timer;
+	atomic<int> next_task{0}, tasks_done{0};
+	mutex print_mutex;
+	auto worker = [&]() {
+		for (int t = next_task++; t < num_tasks; t = next_task++) {
+			auto& p = pdbs[t / NumGroups];
+			p.first->calculate_group(t % NumGroups, *p.second);
+
+			/* report progress in steps of 10% */
+			int done = ++tasks_done;
+			if (done * 10 / num_tasks != (done - 1) * 10 / num_tasks) {
+				lock_guard<mutex> lock(print_mutex);
+				println("PDB tables: ", done, "/", num_tasks, " (", 
+					timer_seconds(timer), "s)");
+			}
+		}
+	};
+	vector<thread> threads;
+	for (int i = 1; i < num_threads; ++i) threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
 }
 
 void create_random_static_pdbs_greedy(int num_pdbs_to_create) {
 	println("create_random_static_pdbs_greedy");
 	RandomNumberGenerator<> rng;
-#if NumRandomStaticPDBs == 0
-	rng.seed(24031992);
-#else 
-#if ParamRandomSeed != -1
-	rng.seed(ParamRandomSeed);
-#else 
-	rng.randomize();
-#endif 
-#endif 
+	if (NumRandomStaticPDBs == 0) {
+		rng.seed(24031992);
+	} else if (ParamRandomSeed != -1) {
+		rng.seed(ParamRandomSeed);
+	} else {
+		rng.randomize();
+	}
 
 	using Perm = vector<vector<int>>;
 	set<Perm> P;
@@ -93,9 +146,9 @@ void create_random_static_pdbs_greedy(int num_pdbs_to_create) {
 		vector<int> r(NumAtoms);
 		for (int j = 0; j < NumAtoms; ++j) r[j] = j;
 		shuffle(begin(r), end(r), rng.engine());
-		Perm p((int)ceil(NumAtoms/3.0));
+		Perm p(NumGroups);
 		for (int j = 0; j < NumAtoms; ++j) {
-			p[j / 3].push_back(r[j]);
+			p[j / GroupSize].push_back(r[j]);
 		}
 		for (auto& i : p) sort(begin(i), end(i));
 		sort_perm(p);		
@@ -165,245 +218,303 @@ void create_random_static_pdbs_greedy(int num_pdbs_to_create) {
 		print("\n");
 	}
 
+	vector<pair<StaticPDB*, const State*>> pdbs;
 	for (int f = 0; f < NumFinalStates; ++f) {
 		for (int i = 0; i < num_pdbs_to_create; ++i) {
 			auto& p = P3[i].second;
 
-			memset(random_pdb[f][i].atom_group, -1, 
-				sizeof(random_pdb[f][i].atom_group));
-
-			int g3_index = 0, g3_count = 0;
+			/* the groups of p are sorted by decreasing size, as are the groups
+			 * of a StaticPDB */
 			for (int g = 0; g < (int)p.size(); ++g) {
-				if (p[g].size() == 3) {
-					for (int k = 0; k < 3; ++k) {
-						random_pdb[f][i].group3[g3_index++] = p[g][k];
-						random_pdb[f][i].atom_group[p[g][k]] = g3_count;
-					}
-					++g3_count;
-				}
-#if Num2Groups > 0
-				if (p[g].size() == 2) {
-					random_pdb[f][i].group2[0] = p[g][0];
-					random_pdb[f][i].group2[1] = p[g][1];
-				}
-#elif Num1Groups > 0
-				if (p[g].size() == 1) {
-					random_pdb[f][i].group1 = p[g][0];
-				}
-#endif 			
+				assert((int)p[g].size() == random_pdb[f][i].num_group_atoms(g));
+				for (int j = 0; j < (int)p[g].size(); ++j)
+					random_pdb[f][i].group[g * GroupSize + j] = p[g][j];
 			}
-			random_pdb[f][i].calculate(final_states[f]);
+			random_pdb[f][i].init_groups();
+			pdbs.emplace_back(&random_pdb[f][i], &final_states[f]);
 		}
 	}
+	calculate_static_pdbs(pdbs);
 	println("create_random_static_pdbs_greedy done");
 }
 
 void create_random_static_pdbs_random() {
-	constexpr auto num_greedy = MyMin(2, NumRandomStaticPDBs);
+	const auto num_greedy = MyMin(2, NumRandomStaticPDBs);
 	create_random_static_pdbs_greedy(num_greedy);
+	/* the groups are chosen sequentially, so that they don't depend on the
+	 * number of threads */
+	vector<pair<StaticPDB*, const State*>> pdbs;
 	for (int f = 0; f < NumFinalStates; ++f) {
 		for (int i = num_greedy; i < NumRandomStaticPDBs; ++i) {
 			random_pdb[f][i].choose_groups_random();
-			random_pdb[f][i].calculate(final_states[f]);
+			pdbs.emplace_back(&random_pdb[f][i], &final_states[f]);
 		}
 	}
+	calculate_static_pdbs(pdbs);
 }
 
-uchar static_pdb_heuristic(const State& s, int pdb_f_index) {
-	stat_pdb_matching_timer.restart();
-	uchar ans;
-#if NumRandomStaticPDBs == 0
-	ans = pdb[pdb_f_index].heuristic(s);
-#else 
-	ans = 0;
-	for (int i = 0; i < NumRandomStaticPDBs; ++i) {
-		ans = max(ans, random_pdb[pdb_f_index][i].heuristic(s));
-	}
-#endif 	
+/* the PDBs of final state f */
+#define FinalStatePDBs(f) (random_pdb[f])
+#define NumFinalStatePDBs MyMax(1, NumRandomStaticPDBs)
 
-#if PrintRandomStaticPDBUsage and NumRandomStaticPDBs > 0
+/* returns the maximum of the heuristics of the PDBs of a final state, given
+ * in h, and counts which PDB gave it */
+static uchar max_pdb_heuristic(const int* h) {
+	int ans = 0;
+	for (int i = 0; i < NumFinalStatePDBs; ++i)
+		ans = max(ans, h[i]);
+#if PrintRandomStaticPDBUsage
 	for (int i = 0; i < NumRandomStaticPDBs; ++i) {
-		if (ans == random_pdb[pdb_f_index][i].heuristic(s)) {
+		if (ans == h[i]) {
 			++random_pdb_usage[i];
 			break;
 		}
 	}
 #endif
+	return ans;
+}
+
+uchar static_pdb_heuristic(const State& s, int pdb_f_index) {
+	stat_pdb_matching_timer.restart();
+	auto pdbs = FinalStatePDBs(pdb_f_index);
+	int h[MyMax(1, MaxNumRandomStaticPDBs)];
+	for (int i = 0; i < NumFinalStatePDBs; ++i)
+		h[i] = pdbs[i].heuristic(s);
+	uchar ans = max_pdb_heuristic(h);
 	stat_pdb_matching_time += stat_pdb_matching_timer.elapsed();
+	return ans;
+}
 
+/* the parent whose group entries are cached, and, for every final state f, 
+ * the entries of the groups of its PDBs and their sums. the entries of f are
+ * valid if parent_cache_stamp[f] == parent_stamp */
+static SearchThreadLocal Pos parent_v[NumAtoms];
+static SearchThreadLocal unsigned parent_stamp = 0;
+static SearchThreadLocal unsigned parent_cache_stamp[MaxFinalStates];
+static SearchThreadLocal uchar parent_entry[MaxFinalStates]
+	[MyMax(1, MaxNumRandomStaticPDBs)][NumGroups];
+static SearchThreadLocal int parent_sum[MaxFinalStates]
+	[MyMax(1, MaxNumRandomStaticPDBs)];
+
+uchar static_pdb_heuristic_delta(const State& s, int pdb_f_index, 
+	const State& parent, int atom_moved) {
+	stat_pdb_matching_timer.restart();
+	const int f = pdb_f_index;
+	auto pdbs = FinalStatePDBs(f);
+	if (memcmp(parent_v, parent.v, sizeof(parent_v)) != 0) {
+		memcpy(parent_v, parent.v, sizeof(parent_v));
+		++parent_stamp;
+	}
+	if (parent_cache_stamp[f] != parent_stamp) {
+		parent_cache_stamp[f] = parent_stamp;
+		for (int i = 0; i < NumFinalStatePDBs; ++i) {
+			parent_sum[f][i] = 0;
+			for (int g = 0; g < NumGroups; ++g) {
+				parent_entry[f][i][g] = pdbs[i].group_entry(g, parent);
+				parent_sum[f][i] += parent_entry[f][i][g];
+			}
+		}
+	}
+
+	int h[MyMax(1, MaxNumRandomStaticPDBs)];
+	for (int i = 0; i < NumFinalStatePDBs; ++i) {
+		h[i] = parent_sum[f][i];
+		for (int m = pdbs[i].moved_groups[atom_moved]; m != 0; m &= m - 1) {
+			int g = __builtin_ctz(m);
+			h[i] += pdbs[i].group_entry(g, s) - parent_entry[f][i][g];
+		}
+		h[i] = uchar(h[i]); /* as returned by StaticPDB::heuristic */
+		assert(h[i] == pdbs[i].heuristic(s));
+	}
+	uchar ans = max_pdb_heuristic(h);
+	stat_pdb_matching_time += stat_pdb_matching_timer.elapsed();
 	return ans;
 }
 
 void StaticPDB::choose_groups_random() {
 	static int a[NumAtoms];
-	memset(atom_group, -1, sizeof(atom_group));
 	for (int i = 0; i < NumAtoms; ++i) a[i] = i;
 	shuffle(begin(a), end(a), RandomNumberGenerator<>::instance().engine());
-	int j = 0;
-	for (int i = 0; i < Num3Groups * 3; ++i) {
-		group3[i] = a[j];
-		atom_group[j] = i / 3;
-		++j;
+	for (int i = 0; i < NumAtoms; ++i) group[i] = a[i];
+	init_groups();
+}
+
+void StaticPDB::init_groups() {
+	for (int i = 0; i < NumAtoms; ++i) atom_group[group[i]] = i / GroupSize;
+	for (int a = 0; a < NumAtoms; ++a) {
+		moved_groups[a] = 0;
+		for (int b = group_begin[a]; b < group_begin[a] + group_size[a]; ++b)
+			moved_groups[a] |= 1 << atom_group[b];
 	}
-#if Num2Groups > 0
-	group2[0] = a[j++]; 	
-	group2[1] = a[j++];
-#elif Num1Groups > 0
-	group1 = a[j++];
-#endif 
+}
+
+/* the index in the table of a group of m atoms, in the given state */
+static inline size_t group_table_index(const int* atoms, int m, 
+	const State& s) {
+	size_t t = 0;
+	for (int j = 0; j < m; ++j)
+		t = t * NumFreePositions + FreeIndex(s.v[atoms[j]]);
+	return t;
+}
+
+int StaticPDB::group_entry(int g, const State& s) {
+#if SmallGroupSize > 0
+	if (g == NumBigGroups)
+		return GetEntry(table[g], group_table_index(&group[g * GroupSize], 
+			SmallGroupSize, s), SmallGroupSize);
+#endif
+	return GetEntry(table[g], 
+		group_table_index(&group[g * GroupSize], GroupSize, s), GroupSize);
 }
 
 uchar StaticPDB::heuristic(const State& s) {
 	int ans = 0;
-	for (int i = 0; i < Num3Groups; ++i)
-		ans += GetPDB3(i, s.v[group3[i * 3]], s.v[group3[i * 3 + 1]], 
-			s.v[group3[i * 3 + 2]]);
-
-#if Num2Groups > 0
-	ans += GetPDB2(s.v[group2[0]], s.v[group2[1]]);
-#elif Num1Groups > 0
-	ans += GetPDB1(s.v[group1]);
-#endif
+	for (int g = 0; g < NumGroups; ++g)
+		ans += group_entry(g, s);
 	return ans;
 }
 
 void StaticPDB::calculate(const State& final_state) {
-	pdb3 = new PDBDataType[Num3Groups*BoardSize*BoardSize*BoardSize];
-	for (int i = 0; i < Num3Groups * pow(BoardSize, 3); ++i)
-		pdb3[i] = numeric_limits<PDBDataType>::max();
-#if Num2Groups > 0
-	pdb2 = new PDBDataType[BoardSize*BoardSize];
-	for (int i = 0; i < BoardSize*BoardSize; ++i)
-		pdb2[i] = numeric_limits<PDBDataType>::max();
-#elif Num1Groups > 0
-	pdb1 = new PDBDataType[BoardSize];
-	for (int i = 0; i < BoardSize; ++i)
-		pdb1[i] = numeric_limits<PDBDataType>::max();
-#endif
-	for (int i = 0; i < Num3Groups; ++i) {
-		bfs_3(i, group3[i * 3], group3[i * 3 + 1], group3[i * 3 + 2],
-			final_state);
-	}
-#if Num2Groups > 0
-	bfs_2(group2[0], group2[1], final_state);
-#elif Num1Groups > 0
-	for (int i = 0; i < BoardSize; ++i)
-		pdb1[i] = relaxed_distances[final_state.v[group1]][i];
-#endif
+	for (int g = 0; g < NumGroups; ++g)
+		calculate_group(g, final_state);
 }
 
-void StaticPDB::bfs_3(int group_index, int a, int b, int c, const State& s) {
-	queue<tuple<int, int, int>> q;
-	auto gba = group_begin[a], gsa = group_size[a],
-		gbb = group_begin[b], gsb = group_size[b],
-		gbc = group_begin[c], gsc = group_size[c];
-	int num_added = 0;
-	for (int i = gba; i < gba + gsa; ++i) {
-		int fa = s.v[i];
-		for (int j = gbb; j < gbb + gsb; ++j) {
-			if (i == j) continue;
-			int fb = s.v[j];
-			for (int k = gbc; k < gbc + gsc; ++k) {
-				if (k == i or k == j) continue;
-				int fc = s.v[k];
-				if (GetPDB3(group_index, fa, fb, fc) ==
-					numeric_limits<PDBDataType>::max()) {
-					GetPDB3(group_index, fa, fb, fc) = 0;
-					q.emplace(fa, fb, fc);
-					++num_added;
-				}
-			}
-		}
+void StaticPDB::calculate_group(int g, const State& final_state) {
+	const int m = num_group_atoms(g);
+	const auto bytes = static_pdb_table_bytes(m);
+	if (m == 1) {
+		/* a single atom has its relaxed distance to its goal */
+		table[g] = static_cast<PDBDataType*>(page_alloc(bytes));
+		memset(table[g], -1, bytes);
+		for (int i = 0; i < NumFreePositions; ++i)
+			pdb_lower(table[g], i, relaxed_distances[
+				final_state.v[group[g * GroupSize]]][board_free_cell[i]], 
+				PDBPacked(1));
+		return;
 	}
+	auto key = table_cache_key(g, final_state);
+	auto cached = pdb_cache_load(key, bytes);
+	if (cached != nullptr) {
+		table[g] = static_cast<PDBDataType*>(cached);
+		table_mapped[g] = true;
+		return;
+	}
+	table[g] = static_cast<PDBDataType*>(page_alloc(bytes));
+	memset(table[g], -1, bytes);
+	bfs(g, final_state);
+	pdb_cache_store(key, table[g], bytes);
+}
 
-	int num_expanded = 0;
-	while (q.size()) {
-		int pa = get<0>(q.front()), pb = get<1>(q.front()),
-			pc = get<2>(q.front());
-		q.pop();
-		++num_expanded;
-
-		auto& cur_dist = GetPDB3(group_index, pa, pb, pc);
-
-		for (int dir : PosDirections) {
-			int pa2 = pa, pb2 = pb, pc2 = pc;
-
-			while (true) {
-				pa2 += dir;
-				if (not pos_valid(pa2) or pa2 == pb or pa2 == pc) break;
-				if (GetPDB3(group_index, pa2, pb, pc) > 1 + cur_dist) {
-					GetPDB3(group_index, pa2, pb, pc) = 1 + cur_dist;
-					q.emplace(pa2, pb, pc);
-				}
-			}
-
-			while (true) {
-				pb2 += dir;
-				if (not pos_valid(pb2) or pb2 == pa or pb2 == pc) break;
-				if (GetPDB3(group_index, pa, pb2, pc) > 1 + cur_dist) {
-					GetPDB3(group_index, pa, pb2, pc) = 1 + cur_dist;
-					q.emplace(pa, pb2, pc);
-				}
-			}
-
-			while (true) {
-				pc2 += dir;
-				if (not pos_valid(pc2) or pc2 == pb or pc2 == pa) break;
-				if (GetPDB3(group_index, pa, pb, pc2) > 1 + cur_dist) {
-					GetPDB3(group_index, pa, pb, pc2) = 1 + cur_dist;
-					q.emplace(pa, pb, pc2);
-				}
-			}
-		}
+uint64_t StaticPDB::table_cache_key(int g, const State& final_state) {
+	/* the table depends on the board, and on the goal positions of the 
+	 * identical-atom groups of the atoms of the group */
+	PDBCacheKey k;
+	k.add(BoardWidth);
+	k.add(BoardSize);
+	k.add(board, BoardSize);
+	k.add(int(sizeof(PDBDataType)));
+	k.add(num_group_atoms(g));
+	k.add(int(PDBPacked(num_group_atoms(g))));
+	k.add(ParamPDBStorage);
+	for (int j = 0; j < num_group_atoms(g); ++j) {
+		int a = group[g * GroupSize + j];
+		k.add(group_begin[a]);
+		k.add(group_size[a]);
+		for (int x = group_begin[a]; x < group_begin[a] + group_size[a]; ++x)
+			k.add(int(final_state.v[x]));
 	}
+	return k.h;
 }
 
-#if Num2Groups > 0
-void StaticPDB::bfs_2(int a, int b, const State& s) {
-	queue<tuple<Pos, Pos>> q;
-
-	auto gba = group_begin[a], gsa = group_size[a],
-		gbb = group_begin[b], gsb = group_size[b];
-	for (int i = gba; i < gba + gsa; ++i) {
-		int fa = s.v[i];
-		for (int j = gbb; j < gbb + gsb; ++j) {
-			if (i == j) continue;
-			int fb = s.v[j];
-			if (GetPDB2(fa, fb) == numeric_limits<PDBDataType>::max()) {
-				GetPDB2(fa, fb) = 0;
-				q.emplace(fa, fb);
-			}
-		}
+/* the BFS of the tables is level-synchronous: the entries at distance d are 
+ * kept in a bitmap over the table indexes, and the entries at distance d + 1
+ * are found by sliding each atom of each of them along the rays of 
+ * board_ray, until it hits another atom of the group. since all moves cost 
+ * one, the first distance given to an entry, which is marked in a third 
+ * bitmap, is the smallest */
+#define BitmapWords(n) (((n) + 63) / 64)
+#define BitmapSet(m, i) ((m)[(i) >> 6] |= 1ull << ((i) & 63))
+#define BitmapTest(m, i) (((m)[(i) >> 6] >> ((i) & 63)) & 1)
+#define ForEachRayCell(x, i, d) \
+	for (const int* x = &board_ray[board_ray_begin[i][d]]; *x != -1; ++x)
+
+/* the BFS of the table tab of a group of M atoms, with M known at compile 
+ * time so that the loops over the atoms unroll */
+template<int M>
+static void bfs_kernel(PDBDataType* tab, const int* atoms, const State& s) {
+	const int F = NumFreePositions;
+
+	/* power[j] is the weight of the free cell of the j-th atom in the index */
+	size_t size = 1, power[M];
+	for (int j = M - 1; j >= 0; --j) {
+		power[j] = size;
+		size *= F;
 	}
-	while (q.size()) {
-		Pos pa = get<0>(q.front()), pb = get<1>(q.front());
-		q.pop();
-
-		auto& cur_dist = GetPDB2(pa, pb);
-		for (auto dir : PosDirections) {
-			Pos pa2 = pa, pb2 = pb;
-
-			while (true) {
-				pa2 += dir;
-				if (not pos_valid(pa2) or pa2 == pb) break;
-				if (GetPDB2(pa2, pb) > 1 + cur_dist) {
-					GetPDB2(pa2, pb) = 1 + cur_dist;
-					q.emplace(pa2, pb);
-				}
+	vector<uint64_t> seen(BitmapWords(size)), cur(seen.size()), 
+		next(seen.size());
+
+	/* the goals are all the placements of the atoms on the goal positions of
+	 * their identical-atom groups, with no two atoms on the same goal */
+	auto seed = [&](auto& self, int j, size_t t, int used) -> void {
+		if (j == M) {
+			if (not BitmapTest(seen, t)) {
+				BitmapSet(seen, t);
+				BitmapSet(cur, t);
+				pdb_lower(tab, t, 0, PDBPacked(M));
 			}
-
-			while (true) {
-				pb2 += dir;
-				if (not pos_valid(pb2) or pb2 == pa) break;
-				if (GetPDB2(pa, pb2) > 1 + cur_dist) {
-					GetPDB2(pa, pb2) = 1 + cur_dist;
-					q.emplace(pa, pb2);
+			return;
+		}
+		int a = atoms[j];
+		for (int i = group_begin[a]; i < group_begin[a] + group_size[a]; ++i)
+			if (not (used & (1 << i)))
+				self(self, j + 1, t + FreeIndex(s.v[i]) * power[j], 
+					used | (1 << i));
+	};
+	seed(seed, 0, 0, 0);
+
+	for (int dist = 1; ; ++dist) {
+		bool found = false;
+		fill(next.begin(), next.end(), 0);
+		for (size_t w = 0; w < cur.size(); ++w) {
+			for (uint64_t bits = cur[w]; bits != 0; bits &= bits - 1) {
+				size_t t = w * 64 + __builtin_ctzll(bits);
+				int cell[M];
+				for (int j = 0; j < M; ++j) cell[j] = t / power[j] % F;
+				for (int j = 0; j < M; ++j) {
+					for (int d = 0; d < 4; ++d) {
+						ForEachRayCell(x, cell[j], d) {
+							bool blocked = false;
+							for (int k = 0; k < M; ++k)
+								if (k != j and cell[k] == *x) blocked = true;
+							if (blocked) break;
+							size_t u = t + (*x - cell[j]) * power[j];
+							if (not BitmapTest(seen, u)) {
+								BitmapSet(seen, u);
+								BitmapSet(next, u);
+								pdb_lower(tab, u, dist, PDBPacked(M));
+								found = true;
+							}
+						}
+					}
 				}
 			}
 		}
+		if (not found) break;
+		swap(cur, next);
+	}
+}
+
+void StaticPDB::bfs(int g, const State& s) {
+	const int* atoms = &group[g * GroupSize];
+	switch (num_group_atoms(g)) {
+	case 2: bfs_kernel<2>(table[g], atoms, s); break;
+	case 3: bfs_kernel<3>(table[g], atoms, s); break;
+	case 4: bfs_kernel<4>(table[g], atoms, s); break;
+	case 5: bfs_kernel<5>(table[g], atoms, s); break;
+	default: assert(false);
 	}
 }
-#endif 
 
 #endif // ParamPDB == PDBStatic
 
+} // namespace AtomixNamespace
@@ -26,70 +26,102 @@
 #include "PDB.h"
 #include "Parameters.h"
 #include "Definitions.h"
+#include "PageAlloc.h"
+#include <ciso646>
+#include <cstdint>
+
+namespace AtomixNamespace {
+
+/* the atoms are partitioned into NumBigGroups groups of GroupSize atoms, and 
+ * one group of the SmallGroupSize atoms left, if there are any. each group 
+ * has a table over the free cell indexes of its atoms */
+#define GroupSize ParamPDBGroupSize
+#define NumBigGroups (NumAtoms / GroupSize)
+#define SmallGroupSize (NumAtoms % GroupSize)
+#define NumGroups (NumBigGroups + (SmallGroupSize > 0 ? 1 : 0))
+static_assert(GroupSize >= 3 and GroupSize <= 5, 
+	"ParamPDBGroupSize must be 3, 4 or 5.");
+
+/* tables of groups of 4 or more atoms are always packed, with two entries 
+ * per byte (see PDB.h) */
+#define PDBPacked(m) (ParamPDBStorage == PDBStorageNibble or (m) >= 4)
+
+/* size in bytes of the table of a group of m atoms */
+inline long long static_pdb_table_bytes(int m) {
+	long long n = 1;
+	for (int i = 0; i < m; ++i) n *= NumFreePositions;
+	return pdb_table_bytes(n, PDBPacked(m));
+}
+
+/* size in bytes of the three bitmaps that the BFS of the table of a group 
+ * of m atoms keeps while it runs (see bfs_kernel) */
+inline long long static_pdb_bfs_bytes(int m) {
+	long long n = 1;
+	for (int i = 0; i < m; ++i) n *= NumFreePositions;
+	return 3 * ((n + 63) / 64) * 8;
+}
+
 #define MaxNumStaticPDBs ParamNumRandomStaticPDBs
 #define MaxMemoryForStaticPDBsMB MyMin(2000, ParamMemoryLimit/2)
-#define SingleStaticPDBSizeBytes \
-	(NumFinalStates * BoardSize * BoardSize * BoardSize * (1 + (NumAtoms / 3)))
+#define SingleStaticPDBSizeBytes (NumFinalStates * \
+	(NumBigGroups * static_pdb_table_bytes(GroupSize) + \
+	(SmallGroupSize > 0 ? static_pdb_table_bytes(SmallGroupSize) : 0)))
 #define NumRandomStaticPDBs (MyMin(MaxNumStaticPDBs, \
 	((MaxMemoryForStaticPDBsMB * 1000000LL) / SingleStaticPDBSizeBytes)))
 #define StaticPDBSizeBytes ((1 + NumRandomStaticPDBs) * SingleStaticPDBSizeBytes)
 
-#define Num3Groups ((NumAtoms)/3)
-#if (NumAtoms % 3 == 0)
-#define Num2Groups 0
-#define Num1Groups 0
-#elif (NumAtoms % 3 == 1)
-#define Num2Groups 0
-#define Num1Groups 1
-#else 
-#define Num2Groups 1
-#define Num1Groups 0
-#endif
-
 struct StaticPDB {
 	~StaticPDB() {
-		if (pdb3) delete[] pdb3;
-#if Num2Groups > 0
-		if (pdb2) delete[] pdb2;
-#elif Num1Groups > 0
-		if (pdb1) delete[] pdb1;
-#endif
+		for (int g = 0; g < NumGroups; ++g)
+			if (not table_mapped[g]) 
+				page_free(table[g], static_pdb_table_bytes(num_group_atoms(g)));
 	}
 
 	void calculate(const State& final_state);
 
+	/* computes the table of group g. the tables of different groups can be
+	 * computed concurrently */
+	void calculate_group(int g, const State& final_state);
+
 	void choose_groups_random();
 
+	/* sets atom_group and moved_groups from group */
+	void init_groups();
+
 	uchar heuristic(const State& s);
 
-	void bfs_3(int group_index, int a, int b, int c, const State& s);
+	/* the entry of group g for state s */
+	int group_entry(int g, const State& s);
 
-#if Num2Groups > 0
-	void bfs_2(int a, int b, const State& s);
-#endif 
+	void bfs(int g, const State& s);
+
+	/* number of atoms of group g */
+	int num_group_atoms(int g) const {
+		return g < NumBigGroups ? GroupSize : SmallGroupSize;
+	}
 
-	/* pdb3[i][a][b][c] = x means that the size-3 group with index i, when in
-	 * positions a, b and c, respectively, will have heuristic = x */
-	PDBDataType* pdb3 = nullptr;
-	int group3[Num3Groups * 3];
+	/* key of the table of group g in the PDB cache */
+	uint64_t table_cache_key(int g, const State& final_state);
 
-	/* pdb2[a][b] = x means that the size-2 group (if it exists) will have 
-	 * heuristic = x when in position a and b */
-#if Num2Groups > 0
-	PDBDataType* pdb2 = nullptr;
-	int group2[2];
-#endif 
+	/* table[g][t] = x means that group g, when its atoms are in the free 
+	 * cells whose indexes are the digits of t in base NumFreePositions, in 
+	 * the order of group, will have heuristic = x. the tables of groups of 
+	 * two or more atoms are either allocated, or mapped from the PDB cache */
+	PDBDataType* table[NumGroups] = {};
+	bool table_mapped[NumGroups] = {};
 
-	/* pdb2[a] = x means that the size-1 group (if it exists) will have 
-	 * heuristic = x when in position a */
-#if Num1Groups > 0
-	PDBDataType* pdb1 = nullptr;
-	int group1 = -1;
-#endif
+	/* the atoms of group g are group[g * GroupSize + j], for 
+	 * 0 <= j < num_group_atoms(g) */
+	int group[NumAtoms];
 
-	// the atom group for a given atom. if -1, then it belongs to the 2-group
-	// or 1-group
+	// the group of a given atom
 	int atom_group[NumAtoms];
+
+	/* bit g of moved_groups[a] is set if the entry of group g can change 
+	 * when atom a moves. this is the group of a, and, since the atoms of an
+	 * identical-atom group are kept sorted, the groups of all atoms 
+	 * identical to a */
+	int moved_groups[NumAtoms];
 };
 
 void init_static_pbds();
@@ -101,7 +133,15 @@ void create_random_static_pdbs_random();
 
 uchar static_pdb_heuristic(const State& s, int pdb_f_index);
 
+/* the same as static_pdb_heuristic, for a state s generated from parent by
+ * moving atom_moved. the entries of the groups in parent are cached, so only
+ * the groups in moved_groups are read for s */
+uchar static_pdb_heuristic_delta(const State& s, int pdb_f_index, 
+	const State& parent, int atom_moved);
+
 #if ParamPDB == PDBStatic
-extern StaticPDB pdb[NumFinalStates];
-extern int random_pdb_usage[1 + MyMax(1, NumRandomStaticPDBs)];
-#endif 
\ No newline at end of file
+extern SearchThreadLocal int random_pdb_usage[
+	1 + MyMax(1, MaxNumRandomStaticPDBs)];
+#endif 
+
+} // namespace AtomixNamespace
@@ -27,6 +27,7 @@
 #include "Exceptions.h"
 #include "StaticPDB.h"
 #include "Print.h"
+#include "PageAlloc.h"
 #include <iomanip>
 #include <fstream>
 #include <limits>
@@ -36,34 +37,37 @@
 #include <locale>
 #include <numeric>
 #include <vector>
+#include <cstring>
 
 using namespace std;
 
+namespace AtomixNamespace {
+
 double stat_total_time = 0.0;
 int stat_solution_length = numeric_limits<int>::max();
 int stat_lower_bound = 0;
-size_t stat_nodes_expanded = 0;
-size_t stat_nodes_generated = 0;
-size_t stat_num_reopened_states = 0;
-size_t stat_calls_to_heuristic = 0;
+SearchThreadLocal size_t stat_nodes_expanded = 0;
+SearchThreadLocal size_t stat_nodes_generated = 0;
+SearchThreadLocal size_t stat_num_reopened_states = 0;
+SearchThreadLocal size_t stat_calls_to_heuristic = 0;
 int stat_nodes_generated_at_depth[GuessOnMaximumFValue];
-int stat_nodes_generated_with_f_value[GuessOnMaximumFValue];
-int stat_nodes_expanded_with_f_value[GuessOnMaximumFValue];
-int stat_nodes_generated_with_g_value[GuessOnMaximumFValue];
-int stat_nodes_expanded_with_g_value[GuessOnMaximumFValue];
-int stat_nodes_generated_with_h_value[GuessOnMaximumFValue];
-int stat_nodes_expanded_with_h_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_generated_with_f_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_expanded_with_f_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_generated_with_g_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_expanded_with_g_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_generated_with_h_value[GuessOnMaximumFValue];
+SearchThreadLocal int stat_nodes_expanded_with_h_value[GuessOnMaximumFValue];
 int stat_initial_heuristic = 0;
 Timer<> stat_timer;
 
-Timer<> stat_pdb_update_timer;
-double stat_pdb_update_time = 0.0;
-Timer<> stat_pdb_matching_timer;
-double stat_pdb_matching_time = 0.0;
+SearchThreadLocal Timer<> stat_pdb_update_timer;
+SearchThreadLocal double stat_pdb_update_time = 0.0;
+SearchThreadLocal Timer<> stat_pdb_matching_timer;
+SearchThreadLocal double stat_pdb_matching_time = 0.0;
 
 #if StatCountAvgHashProbes 
-size_t stat_hash_probes = 0;
-size_t stat_hash_find_calls = 0;
+SearchThreadLocal size_t stat_hash_probes = 0;
+SearchThreadLocal size_t stat_hash_find_calls = 0;
 #endif
 
 double stat_current_time() {
@@ -79,6 +83,57 @@ void stat_start_timer() {
 	stat_timer.restart();
 }
 
+StatCounters stat_get_counters() {
+	StatCounters c;
+	c.nodes_expanded = stat_nodes_expanded;
+	c.nodes_generated = stat_nodes_generated;
+	c.calls_to_heuristic = stat_calls_to_heuristic;
+	c.num_reopened_states = stat_num_reopened_states;
+#if StatCountAvgHashProbes
+	c.hash_probes = stat_hash_probes;
+	c.hash_find_calls = stat_hash_find_calls;
+#endif 
+	for (int i = 0; i < GuessOnMaximumFValue; ++i) {
+		c.generated_with_f_value[i] = stat_nodes_generated_with_f_value[i];
+		c.expanded_with_f_value[i] = stat_nodes_expanded_with_f_value[i];
+		c.generated_with_g_value[i] = stat_nodes_generated_with_g_value[i];
+		c.expanded_with_g_value[i] = stat_nodes_expanded_with_g_value[i];
+		c.generated_with_h_value[i] = stat_nodes_generated_with_h_value[i];
+		c.expanded_with_h_value[i] = stat_nodes_expanded_with_h_value[i];
+	}
+	c.pdb_update_time = stat_pdb_update_time;
+	c.pdb_matching_time = stat_pdb_matching_time;
+#if PrintRandomStaticPDBUsage
+	memcpy(c.pdb_usage, random_pdb_usage, sizeof(c.pdb_usage));
+#endif 
+	return c;
+}
+
+void stat_add_counters(const StatCounters& c) {
+	stat_nodes_expanded += c.nodes_expanded;
+	stat_nodes_generated += c.nodes_generated;
+	stat_calls_to_heuristic += c.calls_to_heuristic;
+	stat_num_reopened_states += c.num_reopened_states;
+#if StatCountAvgHashProbes
+	stat_hash_probes += c.hash_probes;
+	stat_hash_find_calls += c.hash_find_calls;
+#endif 
+	for (int i = 0; i < GuessOnMaximumFValue; ++i) {
+		stat_nodes_generated_with_f_value[i] += c.generated_with_f_value[i];
+		stat_nodes_expanded_with_f_value[i] += c.expanded_with_f_value[i];
+		stat_nodes_generated_with_g_value[i] += c.generated_with_g_value[i];
+		stat_nodes_expanded_with_g_value[i] += c.expanded_with_g_value[i];
+		stat_nodes_generated_with_h_value[i] += c.generated_with_h_value[i];
+		stat_nodes_expanded_with_h_value[i] += c.expanded_with_h_value[i];
+	}
+	stat_pdb_update_time += c.pdb_update_time;
+	stat_pdb_matching_time += c.pdb_matching_time;
+#if PrintRandomStaticPDBUsage
+	for (int i = 0; i < 1 + MyMax(1, NumRandomStaticPDBs); ++i)
+		random_pdb_usage[i] += c.pdb_usage[i];
+#endif 
+}
+
 void stat_pretty_print(std::ostream& o) {
 #if PrintNodesGeneratedAtDepth
 	print_stats_array("Nodes generated at depth ", 
@@ -129,6 +184,7 @@ void stat_pretty_print(std::ostream& o) {
 		0 : stat_solution_length, "\n");
 	print_stream(o, "Lower bound: ", stat_lower_bound, "\n");
 	print_stream(o, "Num reopened states: ", stat_num_reopened_states, "\n");
+	page_alloc_report(o);
 #if ParamPDB == PDBMultiGoal or ParamPDB == PDBDynamic
 	print_stream(o, "PDB update time: ", setprecision(5), fixed,
 		stat_pdb_update_time / 1000.0,
@@ -275,3 +331,5 @@ void write_output_file() {
 
 	f.close();
 }
+
+} // namespace AtomixNamespace
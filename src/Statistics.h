@@ -30,28 +30,32 @@
 #include "Definitions.h"
 #include <iostream>
 
+namespace AtomixNamespace {
+
 extern double stat_total_time;
 extern int stat_solution_length;
 extern int stat_lower_bound;
-extern size_t stat_nodes_expanded;
-extern size_t stat_nodes_generated;
-extern size_t stat_calls_to_heuristic;
-extern size_t stat_num_reopened_states;
+extern SearchThreadLocal size_t stat_nodes_expanded;
+extern SearchThreadLocal size_t stat_nodes_generated;
+extern SearchThreadLocal size_t stat_calls_to_heuristic;
+extern SearchThreadLocal size_t stat_num_reopened_states;
 extern int stat_initial_heuristic;
 extern int stat_nodes_generated_at_depth[GuessOnMaximumFValue];
-extern int stat_nodes_generated_with_f_value[GuessOnMaximumFValue];
-extern int stat_nodes_expanded_with_f_value[GuessOnMaximumFValue];
-extern int stat_nodes_generated_with_g_value[GuessOnMaximumFValue];
-extern int stat_nodes_expanded_with_g_value[GuessOnMaximumFValue];
-extern int stat_nodes_generated_with_h_value[GuessOnMaximumFValue];
-extern int stat_nodes_expanded_with_h_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_generated_with_f_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_expanded_with_f_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_generated_with_g_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_expanded_with_g_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_generated_with_h_value[GuessOnMaximumFValue];
+extern SearchThreadLocal int stat_nodes_expanded_with_h_value[GuessOnMaximumFValue];
 extern Timer<> stat_timer;
 
+/* a hash probe is a comparison against a stored state, which hash_find 
+ * only does on a fingerprint match */
 #define StatCountAvgHashProbes true
 
 #if StatCountAvgHashProbes 
-extern size_t stat_hash_probes;
-extern size_t stat_hash_find_calls;
+extern SearchThreadLocal size_t stat_hash_probes;
+extern SearchThreadLocal size_t stat_hash_find_calls;
 #endif 
 
 double stat_current_time();
@@ -67,10 +71,10 @@ void print_stats_array(std::string header_message,
 
 void write_output_file();
 
-extern Timer<> stat_pdb_update_timer;
-extern double stat_pdb_update_time;
-extern Timer<> stat_pdb_matching_timer;
-extern double stat_pdb_matching_time;
+extern SearchThreadLocal Timer<> stat_pdb_update_timer;
+extern SearchThreadLocal double stat_pdb_update_time;
+extern SearchThreadLocal Timer<> stat_pdb_matching_timer;
+extern SearchThreadLocal double stat_pdb_matching_time;
 
 #define StoreNodesGeneratedStats true
 #define PrintNodesGeneratedStats false
@@ -89,3 +93,29 @@ extern double stat_pdb_matching_time;
 #undef PrintRandomStaticPDBUsage
 #define PrintRandomStaticPDBUsage false
 #endif 
+
+/* a copy of the per-thread search counters, so that the HDA* workers can add 
+ * theirs to the main thread's when they finish */
+struct StatCounters {
+	size_t nodes_expanded = 0, nodes_generated = 0, calls_to_heuristic = 0,
+		num_reopened_states = 0;
+#if StatCountAvgHashProbes
+	size_t hash_probes = 0, hash_find_calls = 0;
+#endif 
+	int generated_with_f_value[GuessOnMaximumFValue] = {};
+	int expanded_with_f_value[GuessOnMaximumFValue] = {};
+	int generated_with_g_value[GuessOnMaximumFValue] = {};
+	int expanded_with_g_value[GuessOnMaximumFValue] = {};
+	int generated_with_h_value[GuessOnMaximumFValue] = {};
+	int expanded_with_h_value[GuessOnMaximumFValue] = {};
+	double pdb_update_time = 0.0, pdb_matching_time = 0.0;
+#if PrintRandomStaticPDBUsage
+	int pdb_usage[1 + MyMax(1, MaxNumRandomStaticPDBs)] = {};
+#endif 
+};
+
+StatCounters stat_get_counters();
+
+void stat_add_counters(const StatCounters& c);
+
+} // namespace AtomixNamespace
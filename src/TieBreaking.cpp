@@ -37,7 +37,9 @@
 
 using namespace std;
 
-int fill_order_ranks[NumFinalStates][BoardSize];
+namespace AtomixNamespace {
+
+int fill_order_ranks[MaxFinalStates][MaxBoardSize];
 int max_fill_order = 0;
 
 #if ParamTieBreaking != None
@@ -269,21 +271,22 @@ int tb_nrp(State& s)
 #endif
 
 	int score = 0;
+	const Occupancy occ = occupancy(s);
 	for (int i = 0; i < NumAtoms; ++i) {
-		auto x = nrp_bfs(s, f, i);
+		auto x = nrp_bfs(s, occ, f, i);
 		if (x == relaxed_distances[s.v[i]][F.v[i]])
 			++score;
 	}
 	return score;
 }
 
-int nrp_bfs(State& s, int f, int a) {
+int nrp_bfs(State& s, const Occupancy& occ, int f, int a) {
 	// Optimize this function. for instance, on adrienl_01, which is a 
 	// relatively small instance (2 million nodes), this is already too costly.
 	// We could to an A* here or something else. the problem here is mainly that 
 	// it tries to add too many invalid nodes to the queue.	
 	auto& F = final_states[f];
-	static int dist[BoardSize];
+	static SearchThreadLocal int dist[MaxBoardSize];
 	boost::heap::fibonacci_heap<tuple<int, int, int>, 
 		boost::heap::compare<greater<tuple<int, int, int>>>> pq;
 
@@ -311,15 +314,15 @@ int nrp_bfs(State& s, int f, int a) {
 			}
 		}
 
-		for (int d : PosDirections) {
-			auto x = Vertex(p) + d;
-			while (pos_valid(x) and not s.contains(x)) {
+		for (int d = 0; d < 4; ++d) {
+			int stop = slide(occ, Vertex(p), d);
+			for (int x = Vertex(p); x != stop; ) {
+				x += PosDirections[d];
 				if (dist[x] == -1 or dist[x] > 1 + Gval(p)) {
 					dist[x] = 1 + Gval(p);
 					pq.emplace(dist[x] + relaxed_distances[F.v[a]][x], 
 						dist[x], x);
 				}
-				x += d;
 			}
 		}
 	}
@@ -334,18 +337,19 @@ void compute_fill_order_ranks() {
 	memset(fill_order_ranks, 0, sizeof(fill_order_ranks));
 	for (int f = 0; f < NumFinalStates; ++f) {
 		int level = 1, atoms_removed = 0;
-		int removed[BoardSize];
+		int removed[MaxBoardSize];
 		memset(removed, 0, sizeof(removed));
+		const Occupancy occ = occupancy(final_states[f]);
 
 		auto backward_move_possible = [&](Pos a) {
 			auto is_free = [&](Pos p) {
 				if (board_is_wall(p)) return false;
-				auto c = final_states[f].contains(p);
+				auto c = occ.test(p);
 				return not c or (c and removed[p] and removed[p] != level);
 			};
 
 			auto can_be_obstacle = [&](Pos p) {
-				return board_is_wall(p) or final_states[f].contains(p);
+				return occ.is_obstacle(p);
 			};
 
 			for (int d : PosDirections) {
@@ -389,7 +393,7 @@ void compute_fill_order_ranks() {
 #endif					
 			}
 		}
-		int foF[BoardSize]; 
+		int foF[MaxBoardSize]; 
 		memcpy(foF, fill_order_ranks[f], BoardSize * sizeof(int));
 		sort(&foF[0], &foF[0] + BoardSize, std::greater<int>());
 		int largest = 1;
@@ -400,4 +404,6 @@ void compute_fill_order_ranks() {
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
+
+} // namespace AtomixNamespace
@@ -24,8 +24,11 @@
 */
 #pragma once
 #include "State.h"
+#include "Occupancy.h"
 #include "Parameters.h"
 
+namespace AtomixNamespace {
+
 #if ParamHeuristic == HeuAllFinalStates
 void tie_breaking(State& s, int f);
 #elif ParamHeuristic == HeuOneFinalState
@@ -58,10 +61,10 @@ int tb_nrp(State& s, int f);
 int tb_nrp(State& s);
 #endif
 
-int nrp_bfs(State& s, int f, int a);
+int nrp_bfs(State& s, const Occupancy& occ, int f, int a);
 
 void compute_fill_order_ranks();
-extern int fill_order_ranks[NumFinalStates][BoardSize];
+extern int fill_order_ranks[MaxFinalStates][MaxBoardSize];
 extern int max_fill_order;
 
 #define RandomTBRangeSize 250
@@ -80,4 +83,6 @@ extern int max_fill_order;
 	#define MaxTieBreakingValue ((1+GuessOnMaximumFValue)*(1+NumAtoms))
 #else 
 	#define MaxTieBreakingValue 1
-#endif
\ No newline at end of file
+#endif
+
+} // namespace AtomixNamespace
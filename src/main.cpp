@@ -22,155 +22,43 @@
 * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
-#include "AStar.h"
-#include "AllFinalStates.h"
-#include "Atomix.h"
-#include "Exceptions.h"
-#include "OneFinalState.h"
-#include "Parameters.h"
-#include "Print.h"
-#include "RSS.h"
-#include "RandomNumberGenerator.h"
-#include "StaticPDB.h"
-#include "Statistics.h"
-#include <ciso646>
-#include <fstream>
+#include "Instance.h"
+#include "Options.h"
+#include "Definitions.h"
+#include <cstdlib>
 #include <iostream>
-#include <sstream>
-#include <thread>
+#include <ciso646>
 
 using namespace std;
 
-void count_time() {
-  for (unsigned i = 0; i < ParamTimeLimit; ++i) {
-    this_thread::sleep_for(chrono::seconds(1));
-  }
-  print("Time limit of ", ParamTimeLimit,
-        "s exceeded. "
-        "Terminating program.\n");
-  termination_requested = true;
-}
-
-void check_memory() {
-  int ms_to_sleep = 500;
-  while (true) {
-    this_thread::sleep_for(chrono::milliseconds(ms_to_sleep));
-    current_memory = getCurrentRSS() / (1024u * 1024u);
-    if (current_memory > ParamMemoryLimit * 1.05) {
-      print("Memory limit of ", ParamMemoryLimit * 1.5,
-            "MB exceeded. "
-            "Terminating program.\n");
-      termination_requested = true;
-      return;
-    }
-  }
-}
-
-void test() {}
-
-vector<State> run() {
-#if ParamAlgorithm == AlgIDAStar
-#else
-#if ParamHeuristic == HeuAllFinalStates
-  return all_final_states();
-#elif ParamHeuristic == HeuOneFinalState
-  return one_final_state();
-#endif
+/* AtomixBuckets is defined by the Makefile as X(n) for each number of atoms n
+ * the solver was built for */
+#ifndef AtomixBuckets
+#error "AtomixBuckets must be defined; build with the Makefile"
 #endif
-}
 
-void generate_nn_data() {
-  int final_state_index = min(1, NumFinalStates - 1);
-  auto sols = backward_bfs(final_states[final_state_index], 10000, 15);
-
-  ostringstream ss;
-  for (auto& path : sols) {
-    for (int i = (int)path.size() - 2; i >= 0; --i) {
-      int atom_moved = -1, dir_moved = 0;
-      for (int a = 0; a < NumAtoms; ++a) {
-        ss << index_to_label[a] << " " << (int)path[i].v[a] << " ";
-        int pos_after = path[i].v[a], pos_before = path[i + 1].v[a];
-        if (pos_after != pos_before) {
-          atom_moved = a;
-          if (pos_c(pos_after) > pos_c(pos_before)) dir_moved = Dir::Right;
-          if (pos_c(pos_after) < pos_c(pos_before)) dir_moved = Dir::Left;
-          if (pos_r(pos_after) < pos_r(pos_before)) dir_moved = Dir::Up;
-          if (pos_r(pos_after) > pos_r(pos_before)) dir_moved = Dir::Down;
-        }
-      }
-      ss << (int)atom_moved << " " << dir_moved << endl;
-    }
-  }
-  ofstream file("nn.dat");
-  file << ss.str();
-}
+#define X(n) namespace BucketNamespace(n) { int solve(); }
+AtomixBuckets
+#undef X
 
 int main(int argc, char** argv) {
-  std::locale comma_locale(std::locale(), new comma_numpunct());
-  std::cout.imbue(comma_locale);
-
-  thread timer_checker_thread([&]() { count_time(); });
-  timer_checker_thread.detach();
-
-  thread memory_checker_thread([&]() { check_memory(); });
-  memory_checker_thread.detach();
-
-#if ParamPrintInitialHeuristic
-  preprocess();
-  println(calc_initial_heuristic());
-  exit(0);
-#endif
-
-#if ParamRandomSeed >= 0
-  RandomNumberGenerator<>::instance().seed(ParamRandomSeed);
-#endif
-
-  try {
-    preprocess();
-
-#if GenerateNnData
-    print("Generating data to train a NN; this is for testing. See "
-          "Definitions.h to disable it.\n");
-    generate_nn_data();
-    exit(EXIT_SUCCESS);
-#endif
-
-    if (argc == 2 and string(argv[1]) == "-t") {
-      test();
-      exit(EXIT_SUCCESS);
-    }
-    stat_initial_heuristic = calc_initial_heuristic();
-    println("Running...");
-    auto x = run();
-    stat_solution_length = x.size() ? x[0].f_value() : 0;
-    stat_lower_bound = x.size() ? stat_solution_length : stat_lower_bound;
-    if (stat_solution_length > 0) {
-      println("\nSolution found!");
-      x[0].pretty_print();
-      println("");
-
-      if (ParamPrintOutputPath) {
-        println("Solution path:");
-        for (int i = (int)x.size() - 1; i >= 0; --i) {
-          // println("begin_path ", x.size() - i);
-          x[i].pretty_print();
-          // println("end_path ", x.size() - i);
-        }
-      }
-    }
-  } catch (std::bad_alloc& e) {
-    println("Bad alloc: ", e.what());
-    exit(EXIT_FAILURE);
-  } catch (TerminationException& e) {
-    println("Termination Exception: ", e.what(), "\n");
-    stat_solution_length = 0;
-  } catch (std::exception& e) {
-    print("Error, exception thrown: ");
-    print(e.what());
-    exit(EXIT_FAILURE);
-  }
-  stat_stop_timer();
-  write_output_file();
-  stat_pretty_print();
-  println("\n");
+	if (not parse_options(argc, argv)) {
+		print_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (not read_instance(option_input_file)) {
+		return EXIT_FAILURE;
+	}
+
+	switch (instance_num_atoms) {
+#define X(n) case n: return BucketNamespace(n)::solve();
+	AtomixBuckets
+#undef X
+	}
+
+	cerr << "The solver was not built for instances with " 
+		<< instance_num_atoms << " atoms. Add " << instance_num_atoms 
+		<< " to Buckets in the Makefile, or build with\n  make Buckets=" 
+		<< instance_num_atoms << "\n";
+	return EXIT_FAILURE;
 }